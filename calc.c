@@ -0,0 +1,351 @@
+//-------------------------------------------------------------------------
+// calc.c
+// Float expressions, see calc.h.  calcCompile() is a recursive descent
+// parser that emits postfix stack code as it goes, checking the stack
+// depth the code will need, so calcRun() is a plain loop with no checks.
+// 10/18/2026 - Initial version
+//-------------------------------------------------------------------------
+
+#include <stdint.h>
+#include "cmpe240.h"
+#include "ieee.h"
+#include "calc.h"
+
+// Stack code.  OP_CONST, OP_REG and OP_STORE are followed by an index
+// byte, into consts [] or calcRegs [].
+#define OP_END          0
+#define OP_CONST        1
+#define OP_REG          2
+#define OP_STORE        3                 // top of stack into a register, kept
+#define OP_ADD          4
+#define OP_SUB          5
+#define OP_MUL          6
+#define OP_NEG          7
+#define OP_FMA          8
+#define OP_ENC          9
+
+#define REG_ANS         26
+#define SIGN_BIT        0x80000000u
+
+static IEEE_FLT calcRegs [CALC_REGS];
+
+typedef struct
+   {
+   const char *p;                         // next character
+   const char *end;
+   CALCPROG   *prog;
+   int32_t     depth;                     // values on the stack at this point
+   int32_t     lastConst;                 // code offset of the newest OP_CONST
+   uint32_t    err;
+   } CALCSRC;
+
+static void expr(CALCSRC *src);
+
+
+/*---------------------------------------------------------------------------
+  Appends op and, for ops that take one, its index byte.  push is the
+  change in stack depth the op makes.
+---------------------------------------------------------------------------*/
+static void emit(CALCSRC *src, uint32_t op, int32_t push)
+   {
+   if (src->prog->len >= CALC_CODE_LEN)
+      {
+      src->err = CALC_TOO_BIG;
+      return;
+      }
+   src->prog->code [src->prog->len++] = op;
+   src->depth += push;
+   if (src->depth > CALC_STACK) src->err = CALC_TOO_BIG;
+   } // End emit()
+
+static void emitIndex(CALCSRC *src, uint32_t op, uint32_t index, int32_t push)
+   {
+   emit(src, op, push);
+   emit(src, index, 0);
+   } // End emitIndex()
+
+static void emitConst(CALCSRC *src, IEEE_FLT value)
+   {
+   CALCPROG *prog = src->prog;
+
+   if (prog->nConsts >= CALC_CONSTS)
+      {
+      src->err = CALC_TOO_BIG;
+      return;
+      }
+   prog->consts [prog->nConsts] = value;
+   src->lastConst = prog->len;
+   emitIndex(src, OP_CONST, prog->nConsts++, 1);
+   } // End emitConst()
+
+
+/*---------------------------------------------------------------------------
+  The next non blank character, 0 at the end of the text.  accept() also
+  steps over it if it is c.
+---------------------------------------------------------------------------*/
+static uint32_t peek(CALCSRC *src)
+   {
+   while (src->p < src->end && *src->p == ' ') src->p++;
+   return (src->p < src->end) ? (uint8_t)*src->p : 0;
+   } // End peek()
+
+static uint32_t accept(CALCSRC *src, uint32_t c)
+   {
+   if (peek(src) != c) return 0;
+   src->p++;
+   return 1;
+   } // End accept()
+
+static uint32_t isWordChar(uint32_t c)
+   {
+   return (c - '0') < 10 || ((c | 0x20) - 'a') < 26 || c == '.';
+   } // End isWordChar()
+
+
+/*---------------------------------------------------------------------------
+  Steps over one operand or name and returns its length.  In a word that
+  starts like a number, a sign right after an e belongs to the exponent.
+---------------------------------------------------------------------------*/
+static uint32_t word(CALCSRC *src, const char **start)
+   {
+   const char *p = src->p;
+   uint32_t number = (uint32_t)(*p - '0') < 10 || *p == '.';
+
+   *start = p;
+   for (p++; p < src->end; p++)
+      {
+      if (isWordChar((uint8_t)*p)) continue;
+      if (number && (*p == '+' || *p == '-') && (p [-1] | 0x20) == 'e') continue;
+      break;
+      }
+   src->p = p;
+   return p - *start;
+   } // End word()
+
+static uint32_t wordIs(const char *w, uint32_t len, const char *name)
+   {
+   while (len > 0 && (*w | 0x20) == *name)
+      {
+      w++;
+      name++;
+      len--;
+      }
+   return len == 0 && *name == 0;
+   } // End wordIs()
+
+
+/*---------------------------------------------------------------------------
+  The bits of a float written as exactly 8 hex digits.  Returns 1 if w is
+  one.
+---------------------------------------------------------------------------*/
+static uint32_t hexBits(const char *w, IEEE_FLT *value)
+   {
+   uint32_t i, c;
+
+   *value = 0;
+   for (i = 0; i < 8; i++)
+      {
+      c = (uint8_t)w [i];
+      if (c - '0' < 10)
+         c -= '0';
+      else if ((c | 0x20) - 'a' < 6)
+         c = (c | 0x20) - 'a' + 10;
+      else
+         return 0;
+      *value = (*value << 4) | c;
+      }
+   return 1;
+   } // End hexBits()
+
+
+/*---------------------------------------------------------------------------
+  "(" expr { "," expr } ")" with exactly count expressions.
+---------------------------------------------------------------------------*/
+static void args(CALCSRC *src, uint32_t count)
+   {
+   if (!accept(src, '('))
+      {
+      src->err = CALC_SYNTAX;
+      return;
+      }
+   while (count-- > 0 && src->err == CALC_OK)
+      {
+      expr(src);
+      if (!accept(src, count ? ',' : ')')) src->err = CALC_SYNTAX;
+      }
+   } // End args()
+
+
+/*---------------------------------------------------------------------------
+  primary := "(" expr ")" | hex | decimal | a - z | ans
+           | fma(expr, expr, expr) | enc(expr, expr)
+---------------------------------------------------------------------------*/
+static void primary(CALCSRC *src)
+   {
+   const char *w;
+   uint32_t len, c;
+   IEEE_FLT value;
+
+   c = peek(src);
+   if (c == '(')
+      {
+      src->p++;
+      expr(src);
+      if (!accept(src, ')')) src->err = CALC_SYNTAX;
+      return;
+      }
+   if (!isWordChar(c))
+      {
+      src->err = CALC_SYNTAX;
+      return;
+      }
+
+   len = word(src, &w);
+   if (len == 8 && hexBits(w, &value))
+      emitConst(src, value);
+   else if ((uint32_t)(c - '0') < 10 || c == '.')
+      {
+      if (IeeeParse(w, len, &value))
+         emitConst(src, value);
+      else
+         src->err = CALC_SYNTAX;
+      }
+   else if (len == 1)
+      emitIndex(src, OP_REG, (c | 0x20) - 'a', 1);
+   else if (wordIs(w, len, "ans"))
+      emitIndex(src, OP_REG, REG_ANS, 1);
+   else if (wordIs(w, len, "fma"))
+      {
+      args(src, 3);
+      emit(src, OP_FMA, -2);
+      }
+   else if (wordIs(w, len, "enc"))
+      {
+      args(src, 2);
+      emit(src, OP_ENC, -1);
+      }
+   else
+      src->err = CALC_SYNTAX;
+   } // End primary()
+
+
+/*---------------------------------------------------------------------------
+  unary := "-" unary | "+" unary | primary
+  A minus right in front of a literal flips the literal instead.
+---------------------------------------------------------------------------*/
+static void unary(CALCSRC *src)
+   {
+   CALCPROG *prog = src->prog;
+
+   if (accept(src, '-'))
+      {
+      unary(src);
+      if (src->lastConst == prog->len - 2)
+         prog->consts [prog->code [prog->len - 1]] ^= SIGN_BIT;
+      else
+         emit(src, OP_NEG, 0);
+      }
+   else if (accept(src, '+'))
+      unary(src);
+   else
+      primary(src);
+   } // End unary()
+
+
+/*---------------------------------------------------------------------------
+  term := unary { "*" unary }
+  expr := term { ("+" | "-") term }
+---------------------------------------------------------------------------*/
+static void term(CALCSRC *src)
+   {
+   unary(src);
+   while (src->err == CALC_OK && accept(src, '*'))
+      {
+      unary(src);
+      emit(src, OP_MUL, -1);
+      }
+   } // End term()
+
+static void expr(CALCSRC *src)
+   {
+   uint32_t c;
+
+   term(src);
+   while (src->err == CALC_OK && ((c = peek(src)) == '+' || c == '-'))
+      {
+      src->p++;
+      term(src);
+      emit(src, c == '+' ? OP_ADD : OP_SUB, -1);
+      }
+   } // End expr()
+
+
+/*---------------------------------------------------------------------------
+  Compiles the len characters at text, [a - z "="] expr, into prog.
+  Returns CALC_OK, CALC_SYNTAX or CALC_TOO_BIG.
+---------------------------------------------------------------------------*/
+uint32_t calcCompile(const char *text, uint32_t len, CALCPROG *prog)
+   {
+   CALCSRC src;
+   const char *w;
+   uint32_t target = CALC_REGS;
+
+   src.p         = text;
+   src.end       = text + len;
+   src.prog      = prog;
+   src.depth     = 0;
+   src.lastConst = -1;
+   src.err       = CALC_OK;
+   prog->len     = 0;
+   prog->nConsts = 0;
+
+   if (((peek(&src) | 0x20) - 'a') < 26)
+      {
+      if (word(&src, &w) == 1 && accept(&src, '='))
+         target = (*w | 0x20) - 'a';
+      else
+         src.p = text;
+      }
+   expr(&src);
+   if (target != CALC_REGS) emitIndex(&src, OP_STORE, target, 0);
+   emit(&src, OP_END, 0);
+   if (src.err == CALC_OK && peek(&src) != 0) src.err = CALC_SYNTAX;
+   return src.err;
+   } // End calcCompile()
+
+
+/*---------------------------------------------------------------------------
+  Runs a program from calcCompile() and returns its value, which also
+  becomes ans.  a - b is a + (-b), which IEEE arithmetic makes exact.
+---------------------------------------------------------------------------*/
+IEEE_FLT calcRun(const CALCPROG *prog)
+   {
+   IEEE_FLT stack [CALC_STACK];
+   IEEE_FLT *sp = stack;                  // next free slot
+   const uint8_t *pc = prog->code;
+   INT_FRACT ef;
+
+   for (;;)
+      {
+      switch (*pc++)
+         {
+         case OP_CONST: *sp++ = prog->consts [*pc++];                    break;
+         case OP_REG:   *sp++ = calcRegs [*pc++];                        break;
+         case OP_STORE: calcRegs [*pc++] = sp [-1];                      break;
+         case OP_ADD:   sp--; sp [-1] = IeeeAdd(sp [-1], sp [0]);        break;
+         case OP_SUB:   sp--; sp [-1] = IeeeAdd(sp [-1], sp [0] ^ SIGN_BIT); break;
+         case OP_MUL:   sp--; sp [-1] = IeeeMult(sp [-1], sp [0]);       break;
+         case OP_NEG:   sp [-1] ^= SIGN_BIT;                             break;
+         case OP_FMA:   sp -= 2; sp [-1] = IeeeFma(sp [-1], sp [0], sp [1]); break;
+         case OP_ENC:
+            sp--;
+            ef.real     = sp [-1];
+            ef.fraction = sp [0];
+            sp [-1] = IeeeEncode(ef);
+            break;
+         default:                         // OP_END
+            calcRegs [REG_ANS] = sp [-1];
+            return sp [-1];
+         }
+      }
+   } // End calcRun()
@@ -0,0 +1,44 @@
+//-------------------------------------------------------------------------
+// calc.h
+// Float expressions for the calc command.  A line is compiled once into
+// a few bytes of stack code and then run with IeeeMult(), IeeeAdd(),
+// IeeeFma() and IeeeEncode(), so a whole computation costs one command.
+//
+//   calc (a * b) + (c * d)          calc x = 13.125 * 2
+//   calc fma(x, 41520000, -1e-7)    calc ans * ans
+//
+// Operands are 8 hex digits (the float's bits), decimals, the registers
+// a - z, which keep their values from line to line, and ans, the last
+// result.  Operators are + - * and unary minus, with fma(a, b, c) and
+// enc(integer, fraction) as functions.
+// 10/18/2026 - Initial version
+//-------------------------------------------------------------------------
+
+#ifndef CALC_H
+#define CALC_H
+
+#include <stdint.h>
+
+// IEEE_FLT comes from cmpe240.h, include it first
+
+#define CALC_CODE_LEN   48                // bytes of code per line
+#define CALC_CONSTS     12                // literals per line
+#define CALC_STACK      8                 // evaluation stack depth
+#define CALC_REGS       27                // a - z and ans
+
+#define CALC_OK         0
+#define CALC_SYNTAX     1                 // not an expression
+#define CALC_TOO_BIG    2                 // out of code, literals or stack
+
+typedef struct
+   {
+   uint8_t  code [CALC_CODE_LEN];
+   IEEE_FLT consts [CALC_CONSTS];
+   uint8_t  len;                          // bytes of code used
+   uint8_t  nConsts;
+   } CALCPROG;
+
+uint32_t calcCompile(const char *text, uint32_t len, CALCPROG *prog);
+IEEE_FLT calcRun(const CALCPROG *prog);
+
+#endif // CALC_H
@@ -0,0 +1,853 @@
+//-------------------------------------------------------------------------
+// fat.c
+// Read only FAT16 / FAT32, see fat.h.  One volume is mounted at a time.
+// FAT, directory and partial file sectors go through a sector cache with
+// a pool for each, whole file sectors are read straight into the caller's
+// buffer.  Recently opened files keep their cluster chain as runs in an
+// extent map, so walking one again needs no FAT at all.  The root
+// directory is read once into a hashed index that searchDir() answers
+// from, until the volume generation moves on.  On a device that maps its
+// sectors the cache pools are left out, sectors are used where they are.
+// 10/18/2026 - Initial version
+// 10/18/2026 - fatSeek()
+// 10/18/2026 - LRU sector cache in FAT, directory and data pools, extent map
+// 10/18/2026 - Hashed root directory index, volume generation
+// 10/18/2026 - Mapped devices, fatMap()
+// 10/18/2026 - Map calls counted in devMaps, not devReads
+//-------------------------------------------------------------------------
+
+#include <stdint.h>
+#include "fat.h"
+
+#define ATTR_VOLUME       0x08            // also set in long name entries
+#define ATTR_DIR          0x10
+#define DIR_ENTRY         32
+#define DIR_END           0x00            // first name byte, no more entries
+#define DIR_DELETED       0xE5
+
+#define EOC16             0xFFF8          // end of chain, this and above
+#define EOC32             0x0FFFFFF8
+#define NO_SECTOR         0xFFFFFFFFu
+
+typedef struct
+   {
+   const SECTORDEV *dev;                  // 0 when not mounted
+   uint32_t type;                         // 16 or 32
+   uint32_t fatStart;                     // LBA of the first FAT
+   uint32_t rootStart;                    // FAT16 root directory LBA
+   uint32_t rootSectors;
+   uint32_t rootCluster;                  // FAT32 root directory
+   uint32_t dataStart;                    // LBA of cluster 2
+   uint32_t clusterShift;                 // log2 sectors per cluster
+   uint32_t clusters;                     // data clusters on the volume
+   uint32_t gen;                          // moves on whenever what was read
+                                          // from the volume may be stale
+   } FATVOL;
+
+/*---------------------------------------------------------------------------
+  The sector cache, a pool of sectors each for the FAT, directories and
+  partial file sectors so a long file can't push the directory out.  Each
+  pool is LRU, which keeps nothing of a scan longer than the pool, so the
+  directory pool holds a whole 512 entry FAT16 root directory.
+  FAT_CACHE_FAT, FAT_CACHE_DIR and FAT_CACHE_DATA set the pool sizes at
+  compile time, FAT_EXTENT_FILES and FAT_EXTENT_RUNS the extent map.
+  -DFAT_CACHE_DISABLE leaves one sector to each pool and no extent map,
+  the way it was before, for comparison.
+---------------------------------------------------------------------------*/
+#ifdef FAT_CACHE_DISABLE
+#undef  FAT_CACHE_FAT
+#undef  FAT_CACHE_DIR
+#undef  FAT_CACHE_DATA
+#define FAT_CACHE_FAT     1
+#define FAT_CACHE_DIR     1
+#define FAT_CACHE_DATA    1
+#endif
+#ifndef FAT_CACHE_FAT
+#define FAT_CACHE_FAT     8               // sectors, 4 KB
+#endif
+#ifndef FAT_CACHE_DIR
+#define FAT_CACHE_DIR     32              // 16 KB
+#endif
+#ifndef FAT_CACHE_DATA
+#define FAT_CACHE_DATA    8               // the two ends of a few files
+#endif
+#ifndef FAT_EXTENT_FILES
+#define FAT_EXTENT_FILES  8
+#endif
+#ifndef FAT_EXTENT_RUNS
+#define FAT_EXTENT_RUNS   16              // runs kept for each file
+#endif
+
+/*---------------------------------------------------------------------------
+  The directory index, an open addressed hash of the root directory's
+  files on their 8.3 names.  FAT_INDEX_BITS sets its size, 24 bytes an
+  entry, and it is filled no more than 3/4.  A directory with more files
+  than that is indexed as far as they fit and the rest is scanned.
+  -DFAT_INDEX_DISABLE scans every time.
+---------------------------------------------------------------------------*/
+#ifndef FAT_INDEX_BITS
+#define FAT_INDEX_BITS    10              // 1024 entries, 24 KB, 768 files
+#endif
+#define INDEX_SIZE        (1u << FAT_INDEX_BITS)
+#define INDEX_MAX         (INDEX_SIZE / 4 * 3)
+
+typedef struct
+   {
+   uint32_t lba;                          // NO_SECTOR if empty
+   uint32_t used;                         // cacheTick at the last use
+   uint8_t  data [FAT_SECTOR];
+   } SECSLOT;
+
+typedef struct
+   {
+   SECSLOT  *slot;
+   uint32_t  size;
+   FATHITS  *stats;
+   } SECPOOL;
+
+// A file's cluster chain as runs of consecutive clusters, the first
+// known clusters of it
+typedef struct
+   {
+   uint32_t first;                        // the file's first cluster, 0 if free
+   uint32_t used;
+   uint32_t known;
+   uint32_t runs;
+   struct
+      {
+      uint32_t start;
+      uint32_t len;
+      } run [FAT_EXTENT_RUNS];
+   } FATEXTENT;
+
+static FATVOL    vol;
+static SECSLOT   fatSlots [FAT_CACHE_FAT];
+static SECSLOT   dirSlots [FAT_CACHE_DIR];
+static SECSLOT   dataSlots [FAT_CACHE_DATA];
+static FATEXTENT extents [FAT_EXTENT_FILES];
+static uint32_t  cacheTick;
+
+#ifndef FAT_INDEX_DISABLE
+typedef struct
+   {
+   uint8_t  name [11];                    // name [0] 0 if empty
+   uint8_t  attr;
+   uint8_t  slot;
+   uint32_t lba;
+   uint32_t cluster;
+   uint32_t size;
+   } DIRINDEX;
+
+static struct
+   {
+   uint32_t gen;                          // vol.gen it was built for, 0 none
+   uint32_t count;
+   uint32_t sectors;                      // directory sectors all indexed
+   uint32_t complete;                     // the whole directory is in it
+   DIRINDEX entry [INDEX_SIZE];
+   } dirIndex;
+#endif
+
+FATSTATS fatStats;
+
+static SECPOOL fatPool  = { fatSlots, FAT_CACHE_FAT, &fatStats.fat };
+static SECPOOL dirPool  = { dirSlots, FAT_CACHE_DIR, &fatStats.dir };
+static SECPOOL dataPool = { dataSlots, FAT_CACHE_DATA, &fatStats.data };
+
+
+static uint32_t le16(const uint8_t *p)
+   {
+   return p [0] | (p [1] << 8);
+   } // End le16()
+
+static uint32_t le32(const uint8_t *p)
+   {
+   return p [0] | (p [1] << 8) | (p [2] << 16) | ((uint32_t)p [3] << 24);
+   } // End le32()
+
+
+/*---------------------------------------------------------------------------
+  Reads count sectors, returns FAT_OK or FAT_NO_DEVICE
+---------------------------------------------------------------------------*/
+static uint32_t devRead(const SECTORDEV *dev, uint32_t lba, uint32_t count, uint8_t *buf)
+   {
+   uint32_t got = dev->read(dev->ctx, lba, count, buf);
+
+   fatStats.devReads++;
+   fatStats.devSectors += got;
+   return (got == count) ? FAT_OK : FAT_NO_DEVICE;
+   } // End devRead()
+
+// The same for a device with map, the sectors or 0, counted apart from reads
+static const uint8_t *devMap(const SECTORDEV *dev, uint32_t lba, uint32_t count)
+   {
+   const uint8_t *p = dev->map(dev->ctx, lba, count);
+
+   fatStats.devMaps++;
+   return p;
+   } // End devMap()
+
+
+/*---------------------------------------------------------------------------
+  The sector at lba from pool, read into its least recently used slot if
+  it isn't there already, or straight from a device that maps.  0 if it
+  can't be read.
+---------------------------------------------------------------------------*/
+static const uint8_t *poolSector(SECPOOL *pool, uint32_t lba)
+   {
+   SECSLOT *slot, *oldest = pool->slot;
+   uint32_t i;
+
+   if (vol.dev->map != 0) return devMap(vol.dev, lba, 1);
+   cacheTick++;
+   for (i = 0; i < pool->size; i++)
+      {
+      slot = &pool->slot [i];
+      if (slot->lba == lba)
+         {
+         slot->used = cacheTick;
+         pool->stats->hits++;
+         return slot->data;
+         }
+      if (slot->used < oldest->used) oldest = slot;
+      }
+   pool->stats->misses++;
+   oldest->lba  = NO_SECTOR;
+   oldest->used = 0;
+   if (devRead(vol.dev, lba, 1, oldest->data) != FAT_OK) return 0;
+   oldest->lba  = lba;
+   oldest->used = cacheTick;
+   return oldest->data;
+   } // End poolSector()
+
+static void poolClear(SECPOOL *pool)
+   {
+   uint32_t i;
+
+   for (i = 0; i < pool->size; i++)
+      {
+      pool->slot [i].lba  = NO_SECTOR;
+      pool->slot [i].used = 0;
+      }
+   } // End poolClear()
+
+
+static uint32_t clusterLba(uint32_t cluster)
+   {
+   return vol.dataStart + ((cluster - 2) << vol.clusterShift);
+   } // End clusterLba()
+
+static uint32_t clusterOk(uint32_t cluster)
+   {
+   return cluster >= 2 && cluster - 2 < vol.clusters;
+   } // End clusterOk()
+
+
+/*---------------------------------------------------------------------------
+  The cluster after cluster in its chain, 0 at the end of the chain and
+  NO_SECTOR if the FAT can't be read or points off the volume.
+---------------------------------------------------------------------------*/
+static uint32_t fatNext(uint32_t cluster)
+   {
+   uint32_t off = cluster * (vol.type / 8);
+   const uint8_t *fat = poolSector(&fatPool, vol.fatStart + off / FAT_SECTOR);
+   uint32_t next;
+
+   if (fat == 0) return NO_SECTOR;
+   off %= FAT_SECTOR;
+   if (vol.type == 16)
+      {
+      next = le16(fat + off);
+      if (next >= EOC16) return 0;
+      }
+   else
+      {
+      next = le32(fat + off) & 0x0FFFFFFF;
+      if (next >= EOC32) return 0;
+      }
+   return clusterOk(next) ? next : NO_SECTOR;
+   } // End fatNext()
+
+
+/*---------------------------------------------------------------------------
+  The extent map entry of the file starting at cluster first, 0 if it has
+  none.  extentOpen() makes one, in place of the least recently used.
+---------------------------------------------------------------------------*/
+static FATEXTENT *extentFind(uint32_t first)
+   {
+#ifndef FAT_CACHE_DISABLE
+   uint32_t i;
+
+   for (i = 0; i < FAT_EXTENT_FILES; i++)
+      if (extents [i].first == first)
+         {
+         extents [i].used = ++cacheTick;
+         return &extents [i];
+         }
+#endif
+   (void)first;
+   return 0;
+   } // End extentFind()
+
+static void extentOpen(uint32_t first)
+   {
+#ifndef FAT_CACHE_DISABLE
+   FATEXTENT *ext = extentFind(first);
+   uint32_t i;
+
+   if (ext != 0) return;
+   ext = &extents [0];
+   for (i = 1; i < FAT_EXTENT_FILES; i++)
+      if (extents [i].used < ext->used) ext = &extents [i];
+   ext->first         = first;
+   ext->used          = ++cacheTick;
+   ext->known         = 1;
+   ext->runs          = 1;
+   ext->run [0].start = first;
+   ext->run [0].len   = 1;
+#endif
+   (void)first;
+   } // End extentOpen()
+
+
+/*---------------------------------------------------------------------------
+  The cluster at index in ext's chain, which must be below ext->known
+---------------------------------------------------------------------------*/
+static uint32_t extentCluster(const FATEXTENT *ext, uint32_t index)
+   {
+   uint32_t r;
+
+   for (r = 0; index >= ext->run [r].len; r++) index -= ext->run [r].len;
+   return ext->run [r].start + index;
+   } // End extentCluster()
+
+// cluster, the one after the last known, goes on the end
+static void extentAdd(FATEXTENT *ext, uint32_t cluster)
+   {
+   uint32_t r = ext->runs - 1;
+
+   if (cluster == ext->run [r].start + ext->run [r].len)
+      ext->run [r].len++;
+   else if (ext->runs < FAT_EXTENT_RUNS)
+      {
+      ext->run [r + 1].start = cluster;
+      ext->run [r + 1].len   = 1;
+      ext->runs++;
+      }
+   else
+      return;
+   ext->known++;
+   } // End extentAdd()
+
+
+/*---------------------------------------------------------------------------
+  The cluster at index to in file's chain, going on from cluster at index
+  i.  The extent map answers what it knows and learns what the FAT says
+  past that.  NO_SECTOR if the chain is short or can't be read.
+---------------------------------------------------------------------------*/
+static uint32_t chainWalk(const FATFILE *file, uint32_t i, uint32_t cluster, uint32_t to)
+   {
+   FATEXTENT *ext = extentFind(file->first);
+   uint32_t next;
+
+   if (ext != 0 && ext->known > i + 1)
+      {
+      fatStats.extentHits++;
+      if (to < ext->known) return extentCluster(ext, to);
+      i = ext->known - 1;
+      cluster = extentCluster(ext, i);
+      }
+   for (; i < to; i++)
+      {
+      next = fatNext(cluster);
+      if (next == 0 || next == NO_SECTOR) return NO_SECTOR;
+      if (ext != 0 && ext->known == i + 1) extentAdd(ext, next);
+      cluster = next;
+      }
+   return cluster;
+   } // End chainWalk()
+
+
+/*---------------------------------------------------------------------------
+  Non zero if sector looks like a FAT boot sector with 512 byte sectors
+---------------------------------------------------------------------------*/
+static uint32_t isBootSector(const uint8_t *sector)
+   {
+   uint32_t spc = sector [13];
+
+   return sector [510] == 0x55 && sector [511] == 0xAA &&
+          (sector [0] == 0xEB || sector [0] == 0xE9) &&
+          le16(sector + 11) == FAT_SECTOR &&
+          spc != 0 && (spc & (spc - 1)) == 0 &&
+          le16(sector + 14) != 0 && sector [16] != 0;
+   } // End isBootSector()
+
+
+/*---------------------------------------------------------------------------
+  Mounts the FAT16 or FAT32 volume on dev, either the whole device or the
+  first FAT partition in its MBR.  Does nothing if dev is mounted already.
+  Returns FAT_OK, FAT_NO_DEVICE or FAT_NOT_FAT.
+---------------------------------------------------------------------------*/
+uint32_t fatMount(const SECTORDEV *dev)
+   {
+   static const uint8_t fatParts [] = { 0x04, 0x06, 0x0E, 0x0B, 0x0C };
+   uint8_t *bs = dataSlots [0].data;        // free after fatUnmount()
+   uint32_t start = 0, i, p;
+   uint32_t reserved, fats, fatSize, total, used;
+
+   if (vol.dev == dev && dev != 0) return FAT_OK;
+   fatUnmount();
+   if (devRead(dev, 0, 1, bs) != FAT_OK) return FAT_NO_DEVICE;
+
+   // Not a boot sector itself, so the first FAT partition in the MBR
+   if (!isBootSector(bs))
+      {
+      if (bs [510] != 0x55 || bs [511] != 0xAA) return FAT_NOT_FAT;
+      for (p = 0; p < 4 && start == 0; p++)
+         for (i = 0; i < sizeof(fatParts); i++)
+            if (bs [446 + 16*p + 4] == fatParts [i]) start = le32(bs + 446 + 16*p + 8);
+      if (start == 0) return FAT_NOT_FAT;
+      if (devRead(dev, start, 1, bs) != FAT_OK) return FAT_NO_DEVICE;
+      if (!isBootSector(bs)) return FAT_NOT_FAT;
+      }
+
+   reserved = le16(bs + 14);
+   fats     = bs [16];
+   fatSize  = le16(bs + 22) ? le16(bs + 22) : le32(bs + 36);
+   total    = le16(bs + 19) ? le16(bs + 19) : le32(bs + 32);
+
+   vol.clusterShift = __builtin_ctz(bs [13]);
+   vol.fatStart     = start + reserved;
+   vol.rootStart    = vol.fatStart + fats * fatSize;
+   vol.rootSectors  = (le16(bs + 17) * DIR_ENTRY + FAT_SECTOR - 1) / FAT_SECTOR;
+   vol.dataStart    = vol.rootStart + vol.rootSectors;
+   used             = reserved + fats * fatSize + vol.rootSectors;
+   if (fatSize == 0 || total <= used) return FAT_NOT_FAT;
+   vol.clusters     = (total - used) >> vol.clusterShift;
+
+   // The cluster count alone decides the FAT type, FAT12 is not handled
+   if (vol.clusters < 4085) return FAT_NOT_FAT;
+   vol.type = (vol.clusters < 65525) ? 16 : 32;
+   if (vol.type == 32)
+      {
+      vol.rootCluster = le32(bs + 44);
+      if (!clusterOk(vol.rootCluster)) return FAT_NOT_FAT;
+      }
+   if (vol.clusters > (fatSize * FAT_SECTOR) / (vol.type / 8) - 2) return FAT_NOT_FAT;
+   vol.dev = dev;
+   return FAT_OK;
+   } // End fatMount()
+
+
+/*---------------------------------------------------------------------------
+  Forgets the mounted volume and everything cached from it, the next
+  fatMount() reads it again
+---------------------------------------------------------------------------*/
+void fatUnmount(void)
+   {
+   vol.dev = 0;
+   fatInvalidate();
+   } // End fatUnmount()
+
+
+/*---------------------------------------------------------------------------
+  Drops everything read from the volume but its geometry, for when its
+  files may have changed underneath.  The generation moves on, so the
+  directory index is built again on the next searchDir().
+---------------------------------------------------------------------------*/
+void fatInvalidate(void)
+   {
+   uint32_t i;
+
+   if (++vol.gen == 0) vol.gen = 1;
+   poolClear(&fatPool);
+   poolClear(&dirPool);
+   poolClear(&dataPool);
+   for (i = 0; i < FAT_EXTENT_FILES; i++)
+      {
+      extents [i].first = 0;
+      extents [i].used  = 0;
+      }
+   cacheTick = 0;
+   } // End fatInvalidate()
+
+
+/*---------------------------------------------------------------------------
+  16 or 32 for the mounted volume, 0 if none
+---------------------------------------------------------------------------*/
+uint32_t fatType(void)
+   {
+   return vol.dev ? vol.type : 0;
+   } // End fatType()
+
+
+/*---------------------------------------------------------------------------
+  The directory form of the len characters at name, "TWO.TXT" becomes
+  "TWO     TXT".  Only upper case 8.3 names are valid, the same rule as
+  the type command's "type two.txt".  Returns 1 if name is valid.
+---------------------------------------------------------------------------*/
+static uint32_t fatName(const char *name, uint32_t len, uint8_t *out)
+   {
+   static const char extra [] = "!#$%&'()-@^_`{}~";
+   uint32_t i, n = 0, limit = 8, c;
+   const char *e;
+
+   for (i = 0; i < 11; i++) out [i] = ' ';
+   for (i = 0; i < len; i++)
+      {
+      c = (uint8_t)name [i];
+      if (c == '.' && limit == 8 && n > 0 && i + 1 < len)
+         {
+         n = 8;
+         limit = 11;
+         continue;
+         }
+      for (e = extra; *e && *e != (char)c; e++) ;
+      if (!((c - 'A') < 26 || (c - '0') < 10 || *e)) return 0;
+      if (n == limit) return 0;
+      out [n++] = c;
+      }
+   return n > 0;
+   } // End fatName()
+
+
+/*---------------------------------------------------------------------------
+  Goes through the root directory from its sector skip on, calling visit
+  with each file entry, its sector number in the directory, LBA and slot.
+  Directories, volume labels, long names and deleted entries are passed
+  over.  Returns FAT_OK when visit returns non zero, FAT_NOT_FOUND at the
+  end, FAT_NO_DEVICE or FAT_BAD_CHAIN.
+---------------------------------------------------------------------------*/
+typedef uint32_t (*DIRVISIT)(const uint8_t *d, uint32_t n, uint32_t lba, uint32_t slot, void *arg);
+
+static uint32_t dirWalk(uint32_t skip, DIRVISIT visit, void *arg)
+   {
+   const uint8_t *sector, *d;
+   uint32_t cluster, lba, count, s, n;
+
+   // FAT16 has a fixed root directory, FAT32 a cluster chain
+   cluster = (vol.type == 32) ? vol.rootCluster : 0;
+   lba     = cluster ? clusterLba(cluster) : vol.rootStart;
+   count   = cluster ? (1u << vol.clusterShift) : vol.rootSectors;
+   for (n = 0; ; )
+      {
+      for (s = 0; s < count; s++, n++)
+         {
+         if (n < skip) continue;
+         sector = poolSector(&dirPool, lba + s);
+         if (sector == 0) return FAT_NO_DEVICE;
+         for (d = sector; d < sector + FAT_SECTOR; d += DIR_ENTRY)
+            {
+            if (d [0] == DIR_END) return FAT_NOT_FOUND;
+            if (d [0] == DIR_DELETED || (d [11] & (ATTR_VOLUME | ATTR_DIR))) continue;
+            if (visit(d, n, lba + s, (d - sector) / DIR_ENTRY, arg)) return FAT_OK;
+            }
+         }
+      if (cluster == 0) return FAT_NOT_FOUND;
+      cluster = fatNext(cluster);
+      if (cluster == 0) return FAT_NOT_FOUND;
+      if (cluster == NO_SECTOR) return FAT_BAD_CHAIN;
+      lba = clusterLba(cluster);
+      }
+   } // End dirWalk()
+
+
+#ifndef FAT_INDEX_DISABLE
+/*---------------------------------------------------------------------------
+  The index slot for the directory form name, the empty slot it would go
+  in if it isn't there
+---------------------------------------------------------------------------*/
+static DIRINDEX *indexSlot(const uint8_t *name)
+   {
+   uint32_t hash = 2166136261u, i;
+   DIRINDEX *e;
+
+   for (i = 0; i < 11; i++) hash = (hash ^ name [i]) * 16777619u;
+   for (hash &= INDEX_SIZE - 1; ; hash = (hash + 1) & (INDEX_SIZE - 1))
+      {
+      e = &dirIndex.entry [hash];
+      if (e->name [0] == 0) return e;
+      for (i = 0; i < 11 && e->name [i] == name [i]; i++) ;
+      if (i == 11) return e;
+      }
+   } // End indexSlot()
+
+// dirWalk() visitor that adds the entry, stopping when the index is full
+static uint32_t indexAdd(const uint8_t *d, uint32_t n, uint32_t lba, uint32_t slot, void *arg)
+   {
+   DIRINDEX *e;
+   uint32_t i;
+
+   if (dirIndex.count == INDEX_MAX)
+      {
+      dirIndex.sectors = n;
+      return 1;
+      }
+   e = indexSlot(d);
+   if (e->name [0] != 0) return 0;        // the first of two the same wins
+   for (i = 0; i < 11; i++) e->name [i] = d [i];
+   e->attr    = d [11];
+   e->slot    = slot;
+   e->lba     = lba;
+   e->cluster = le16(d + 26) | (vol.type == 32 ? le16(d + 20) << 16 : 0);
+   e->size    = le32(d + 28);
+   dirIndex.count++;
+   (void)arg;
+   return 0;
+   } // End indexAdd()
+
+
+/*---------------------------------------------------------------------------
+  Fills the index for the current generation, 0 if the directory can't
+  be read
+---------------------------------------------------------------------------*/
+static uint32_t indexBuild(void)
+   {
+   uint32_t i, rc;
+
+   for (i = 0; i < INDEX_SIZE; i++) dirIndex.entry [i].name [0] = 0;
+   dirIndex.gen     = 0;
+   dirIndex.count   = 0;
+   dirIndex.sectors = 0;
+   rc = dirWalk(0, indexAdd, 0);
+   if (rc != FAT_OK && rc != FAT_NOT_FOUND) return 0;
+   dirIndex.complete = (rc == FAT_NOT_FOUND);
+   dirIndex.gen      = vol.gen;
+   fatStats.indexBuilds++;
+   return 1;
+   } // End indexBuild()
+
+
+/*---------------------------------------------------------------------------
+  Decodes name's index entry into *entry, 0 if it has none
+---------------------------------------------------------------------------*/
+static uint32_t indexLookup(const uint8_t *name, FATDIRENT *entry)
+   {
+   const DIRINDEX *e = indexSlot(name);
+   uint32_t i;
+
+   if (e->name [0] == 0) return 0;
+   for (i = 0; i < 11; i++) entry->name [i] = e->name [i];
+   entry->attr    = e->attr;
+   entry->cluster = e->cluster;
+   entry->size    = e->size;
+   entry->lba     = e->lba;
+   entry->slot    = e->slot;
+   fatStats.indexHits++;
+   return 1;
+   } // End indexLookup()
+#endif
+
+
+// dirWalk() visitor that stops at the name being looked for
+typedef struct
+   {
+   const uint8_t *want;
+   FATDIRENT     *entry;
+   } DIRMATCH;
+
+static uint32_t dirMatch(const uint8_t *d, uint32_t n, uint32_t lba, uint32_t slot, void *arg)
+   {
+   DIRMATCH *match = arg;
+   uint32_t i;
+
+   for (i = 0; i < 11 && d [i] == match->want [i]; i++) ;
+   if (i < 11) return 0;
+   for (i = 0; i < 11; i++) match->entry->name [i] = d [i];
+   match->entry->attr    = d [11];
+   match->entry->cluster = le16(d + 26) | (vol.type == 32 ? le16(d + 20) << 16 : 0);
+   match->entry->size    = le32(d + 28);
+   match->entry->lba     = lba;
+   match->entry->slot    = slot;
+   (void)n;
+   return 1;
+   } // End dirMatch()
+
+
+/*---------------------------------------------------------------------------
+  Looks the len characters at name up in the root directory and decodes
+  its entry into *entry.  Directories and volume labels don't match.  The
+  index answers without reading anything, only a directory too big for it
+  is scanned, and then only the part it doesn't hold.
+  Returns FAT_OK, FAT_BAD_NAME, FAT_NOT_FOUND, FAT_NO_DEVICE or
+  FAT_BAD_CHAIN.
+---------------------------------------------------------------------------*/
+uint32_t searchDir(const char *name, uint32_t len, FATDIRENT *entry)
+   {
+   uint8_t want [11];
+   DIRMATCH match = { want, entry };
+   uint32_t skip = 0;
+
+   if (vol.dev == 0) return FAT_NO_DEVICE;
+   if (!fatName(name, len, want)) return FAT_BAD_NAME;
+
+#ifndef FAT_INDEX_DISABLE
+   if (dirIndex.gen == vol.gen || indexBuild())
+      {
+      if (indexLookup(want, entry)) return FAT_OK;
+      if (dirIndex.complete) return FAT_NOT_FOUND;
+      skip = dirIndex.sectors;
+      }
+#endif
+   return dirWalk(skip, dirMatch, &match);
+   } // End searchDir()
+
+
+/*---------------------------------------------------------------------------
+  Opens the root directory file name for fatRead().  Returns the same
+  codes as searchDir().
+---------------------------------------------------------------------------*/
+uint32_t fatOpen(const char *name, uint32_t len, FATFILE *file)
+   {
+   FATDIRENT entry;
+   uint32_t rc = searchDir(name, len, &entry);
+
+   if (rc != FAT_OK) return rc;
+   file->size    = entry.size;
+   file->pos     = 0;
+   file->first   = entry.cluster;
+   file->cluster = entry.cluster;
+   file->err     = FAT_OK;
+   if (file->size != 0 && !clusterOk(file->cluster)) return FAT_BAD_CHAIN;
+   if (file->size != 0) extentOpen(file->first);
+   return FAT_OK;
+   } // End fatOpen()
+
+
+/*---------------------------------------------------------------------------
+  Moves the file n bytes on, into the next cluster once this one is used
+  up.  Returns FAT_OK or FAT_BAD_CHAIN, also left in file->err.
+---------------------------------------------------------------------------*/
+static uint32_t fileStep(FATFILE *file, uint32_t n)
+   {
+   uint32_t index;
+
+   file->pos += n;
+   if ((file->pos & ((FAT_SECTOR << vol.clusterShift) - 1)) == 0 && file->pos < file->size)
+      {
+      index = (file->pos >> (vol.clusterShift + 9)) - 1;
+      file->cluster = chainWalk(file, index, file->cluster, index + 1);
+      if (file->cluster == NO_SECTOR) file->err = FAT_BAD_CHAIN;
+      }
+   return file->err;
+   } // End fileStep()
+
+
+/*---------------------------------------------------------------------------
+  Reads up to len bytes from the file's position into buf and returns the
+  number read, 0 at the end of the file.  A short count before the end
+  means file->err says what went wrong.
+---------------------------------------------------------------------------*/
+uint32_t fatRead(FATFILE *file, uint8_t *buf, uint32_t len)
+   {
+   uint32_t clusterMask = (FAT_SECTOR << vol.clusterShift) - 1;
+   uint32_t done = 0, off, lba, n, count;
+   const uint8_t *sector;
+
+   if (vol.dev == 0 || file->err != FAT_OK) return 0;
+   if (len > file->size - file->pos) len = file->size - file->pos;
+   while (done < len)
+      {
+      off = file->pos & clusterMask;
+      lba = clusterLba(file->cluster) + off / FAT_SECTOR;
+      if (off % FAT_SECTOR == 0 && len - done >= FAT_SECTOR)
+         {
+         // Whole sectors, as many as are left in this cluster
+         count = (clusterMask + 1 - off) / FAT_SECTOR;
+         if (count > (len - done) / FAT_SECTOR) count = (len - done) / FAT_SECTOR;
+         file->err = devRead(vol.dev, lba, count, buf + done);
+         if (file->err != FAT_OK) break;
+         n = count * FAT_SECTOR;
+         }
+      else
+         {
+         sector = poolSector(&dataPool, lba);
+         if (sector == 0)
+            {
+            file->err = FAT_NO_DEVICE;
+            break;
+            }
+         n = FAT_SECTOR - off % FAT_SECTOR;
+         if (n > len - done) n = len - done;
+         for (count = 0; count < n; count++) buf [done + count] = sector [off % FAT_SECTOR + count];
+         }
+      done += n;
+      if (fileStep(file, n) != FAT_OK) break;
+      }
+   return done;
+   } // End fatRead()
+
+
+/*---------------------------------------------------------------------------
+  fatRead() without the copy, for a device that maps.  Returns where the
+  next bytes of the file are and moves past them, *got of them, at most
+  len and no further than the end of the cluster.  0 with *got 0 at the
+  end of the file, after an error in file->err, or if the device doesn't
+  map, then fatRead() is the way.
+---------------------------------------------------------------------------*/
+const uint8_t *fatMap(FATFILE *file, uint32_t len, uint32_t *got)
+   {
+   uint32_t clusterBytes = FAT_SECTOR << vol.clusterShift;
+   uint32_t off = file->pos & (clusterBytes - 1);
+   const uint8_t *p;
+
+   *got = 0;
+   if (vol.dev == 0 || vol.dev->map == 0 || file->err != FAT_OK) return 0;
+   if (len > file->size - file->pos) len = file->size - file->pos;
+   if (len > clusterBytes - off) len = clusterBytes - off;
+   if (len == 0) return 0;
+   p = devMap(vol.dev, clusterLba(file->cluster) + off / FAT_SECTOR,
+              (off % FAT_SECTOR + len + FAT_SECTOR - 1) / FAT_SECTOR);
+   if (p == 0)
+      {
+      file->err = FAT_NO_DEVICE;
+      return 0;
+      }
+   *got = len;
+   fileStep(file, len);
+   return p + off % FAT_SECTOR;
+   } // End fatMap()
+
+
+/*---------------------------------------------------------------------------
+  The index in the chain of the cluster file->cluster is for at pos
+---------------------------------------------------------------------------*/
+static uint32_t clusterIndex(const FATFILE *file, uint32_t pos)
+   {
+   if (pos != 0 && pos == file->size) pos--;
+   return pos >> (vol.clusterShift + 9);
+   } // End clusterIndex()
+
+
+/*---------------------------------------------------------------------------
+  Moves the file to byte pos, or its end if pos is past it, so the next
+  fatRead() starts there.  Only the FAT is read, one entry for each
+  cluster passed beyond what the extent map knows, from the current
+  cluster going forward and from the first going back.  Returns FAT_OK or
+  the error, also left in file->err.
+---------------------------------------------------------------------------*/
+uint32_t fatSeek(FATFILE *file, uint32_t pos)
+   {
+   uint32_t cluster = file->cluster;
+   uint32_t i, to;
+
+   if (vol.dev == 0) return FAT_NO_DEVICE;
+   if (file->err != FAT_OK) return file->err;
+   if (pos > file->size) pos = file->size;
+   i  = clusterIndex(file, file->pos);
+   to = clusterIndex(file, pos);
+   if (to < i)
+      {
+      cluster = file->first;
+      i = 0;
+      }
+   if (i < to) cluster = chainWalk(file, i, cluster, to);
+   if (cluster == NO_SECTOR)
+      {
+      file->err = FAT_BAD_CHAIN;
+      return file->err;
+      }
+   file->cluster = cluster;
+   file->pos     = pos;
+   return FAT_OK;
+   } // End fatSeek()
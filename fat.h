@@ -0,0 +1,105 @@
+//-------------------------------------------------------------------------
+// fat.h
+// Read only FAT16 / FAT32 for the type and size commands.  fatMount()
+// reads the MBR and boot sector once and keeps the volume geometry, after
+// that searchDir() looks names up in the root directory and fatOpen() /
+// fatRead() follow a file's cluster chain, all from the cached geometry.
+// fatSeek() moves through a file reading only the FAT.  Below them is a
+// sector cache, see fat.c, whose hits and misses are in fatStats.
+// searchDir() answers from a hashed index of the root directory, built
+// the first time after a mount or fatInvalidate().
+//
+// Sectors come from a SECTORDEV, hddDev.  Host builds get it from
+// host/diskimg.c, which reads a raw .img file or maps it.  There is no
+// board backend yet: the disk driver behind cmpe240.h is not in this
+// tree and shows no sector read to wrap, so a board build must define
+// hddDev over its SD card driver or fail to link.  A device that can map
+// hands out pointers to its sectors, the cache is passed by and fatMap()
+// gives file data where it lies, with no copy.
+// 10/18/2026 - Initial version
+// 10/18/2026 - fatSeek()
+// 10/18/2026 - Sector cache and extent map counters in FATSTATS
+// 10/18/2026 - Directory index, fatInvalidate(), where an entry is
+// 10/18/2026 - SECTORDEV map, fatMap()
+// 10/18/2026 - Say that hddDev has no board backend yet
+// 10/18/2026 - devMaps, map calls no longer count as reads
+//-------------------------------------------------------------------------
+
+#ifndef FAT_H
+#define FAT_H
+
+#include <stdint.h>
+
+#define FAT_SECTOR        512             // the only sector size handled
+
+#define FAT_OK            0
+#define FAT_NO_DEVICE     1               // a sector read failed
+#define FAT_NOT_FAT       2               // no FAT16 or FAT32 volume
+#define FAT_NOT_FOUND     3
+#define FAT_BAD_NAME      4               // not an upper case 8.3 name
+#define FAT_BAD_CHAIN     5               // a cluster chain leaves the volume
+
+typedef struct
+   {
+   // Reads count sectors from lba into buf, returns the number read
+   uint32_t (*read)(void *ctx, uint32_t lba, uint32_t count, uint8_t *buf);
+   void     *ctx;
+   // Optional, count sectors from lba where they are in memory, 0 if
+   // they are past the end.  They stay put until the device closes.
+   const uint8_t *(*map)(void *ctx, uint32_t lba, uint32_t count);
+   } SECTORDEV;
+
+typedef struct
+   {
+   uint8_t  name [11];                    // space padded, no dot
+   uint8_t  attr;
+   uint32_t cluster;                      // first cluster, 0 if empty
+   uint32_t size;
+   uint32_t lba;                          // the directory sector it is in
+   uint32_t slot;                         // and which of its 16 entries
+   } FATDIRENT;
+
+typedef struct
+   {
+   uint32_t size;
+   uint32_t pos;                          // next byte fatRead() returns
+   uint32_t first;                        // first cluster
+   uint32_t cluster;                      // the cluster holding pos, the
+                                          // last one once pos is size
+   uint32_t err;                          // FAT_OK or why fatRead() stopped
+   } FATFILE;
+
+typedef struct
+   {
+   uint32_t hits;
+   uint32_t misses;                       // each one a sector read
+   } FATHITS;
+
+typedef struct
+   {
+   uint32_t devReads;                     // SECTORDEV read calls
+   uint32_t devSectors;                   // sectors they returned
+   uint32_t devMaps;                      // SECTORDEV map calls, kept apart
+   FATHITS  fat;                          // sector cache, FAT sectors
+   FATHITS  dir;                          // directory sectors
+   FATHITS  data;                         // partial file sectors
+   uint32_t extentHits;                   // chain steps the extent map saved
+   uint32_t indexHits;                    // searchDir() without a scan
+   uint32_t indexBuilds;
+   } FATSTATS;
+
+extern SECTORDEV hddDev;
+extern FATSTATS  fatStats;
+
+uint32_t fatMount(const SECTORDEV *dev);
+void     fatUnmount(void);
+void     fatInvalidate(void);
+uint32_t fatType(void);
+
+uint32_t searchDir(const char *name, uint32_t len, FATDIRENT *entry);
+uint32_t fatOpen(const char *name, uint32_t len, FATFILE *file);
+uint32_t fatRead(FATFILE *file, uint8_t *buf, uint32_t len);
+uint32_t fatSeek(FATFILE *file, uint32_t pos);
+const uint8_t *fatMap(FATFILE *file, uint32_t len, uint32_t *got);
+
+#endif // FAT_H
@@ -0,0 +1,375 @@
+//-------------------------------------------------------------------------
+// fmt.c
+// Number formatting, see fmt.h
+// 10/18/2026 - Initial version
+// 10/18/2026 - fmtFlt()
+//-------------------------------------------------------------------------
+
+#include <stdint.h>
+#include "fmt.h"
+
+// Every value 00 - 99 as two characters, indexed by 2 * value
+static const char digitPairs [200] =
+   "00010203040506070809" "10111213141516171819" "20212223242526272829"
+   "30313233343536373839" "40414243444546474849" "50515253545556575859"
+   "60616263646566676869" "70717273747576777879" "80818283848586878889"
+   "90919293949596979899";
+
+// Every byte 00 - FF as two hex characters, indexed by 2 * value
+static const char hexPairs [512] =
+   "000102030405060708090A0B0C0D0E0F"
+   "101112131415161718191A1B1C1D1E1F"
+   "202122232425262728292A2B2C2D2E2F"
+   "303132333435363738393A3B3C3D3E3F"
+   "404142434445464748494A4B4C4D4E4F"
+   "505152535455565758595A5B5C5D5E5F"
+   "606162636465666768696A6B6C6D6E6F"
+   "707172737475767778797A7B7C7D7E7F"
+   "808182838485868788898A8B8C8D8E8F"
+   "909192939495969798999A9B9C9D9E9F"
+   "A0A1A2A3A4A5A6A7A8A9AAABACADAEAF"
+   "B0B1B2B3B4B5B6B7B8B9BABBBCBDBEBF"
+   "C0C1C2C3C4C5C6C7C8C9CACBCCCDCECF"
+   "D0D1D2D3D4D5D6D7D8D9DADBDCDDDEDF"
+   "E0E1E2E3E4E5E6E7E8E9EAEBECEDEEEF"
+   "F0F1F2F3F4F5F6F7F8F9FAFBFCFDFEFF";
+
+// Smallest value with n digits, 0 for one digit so that zero counts as one
+static const uint32_t decLimit [10] = { 0, 10, 100, 1000, 10000, 100000,
+                                        1000000, 10000000, 100000000, 1000000000 };
+
+// num / 100 for every 32 bit num, one umull instead of a divide
+#define DIV100(num)  ((uint32_t)(((uint64_t)(num) * 0x51EB851Fu) >> 37))
+
+
+/*---------------------------------------------------------------------------
+  Unsigned decimal, no leading zeros.  The buffer must hold FMT_DEC_LEN.
+  The digit count comes from the bit length, log10(2) is about 1233/4096,
+  and the digits are then written backwards two at a time.
+---------------------------------------------------------------------------*/
+uint32_t fmtDec(uint32_t num, char *buff)
+   {
+   uint32_t len, t, q;
+   char *p;
+
+   t   = ((32 - __builtin_clz(num | 1)) * 1233) >> 12;
+   len = t + 1 - (num < decLimit [t]);
+
+   p  = buff + len;
+   *p = 0x00;
+   while (num >= 100)
+      {
+      q    = DIV100(num);
+      t    = (num - q * 100) * 2;
+      num  = q;
+      *--p = digitPairs [t + 1];
+      *--p = digitPairs [t];
+      }
+   if (num >= 10)
+      {
+      *--p = digitPairs [num * 2 + 1];
+      *--p = digitPairs [num * 2];
+      }
+   else
+      {
+      *--p = num + '0';
+      }
+   return len;
+   } // End fmtDec()
+
+
+/*---------------------------------------------------------------------------
+  Eight upper case hex digits.  The buffer must hold FMT_HEX_LEN.  Written
+  backwards a byte, two digits, at a time.
+---------------------------------------------------------------------------*/
+uint32_t fmtHex(uint32_t num, char *buff)
+   {
+   uint32_t i, t;
+
+   for (i = 8; i != 0; i -= 2)
+      {
+      t = (num & 0xFF) * 2;
+      num >>= 8;
+      buff [i - 1] = hexPairs [t + 1];
+      buff [i - 2] = hexPairs [t];
+      }
+   buff [8] = 0x00;
+   return 8;
+   } // End fmtHex()
+
+
+// Ryu tables for fmtFlt().  fltPow5Inv [q] is 2^(b + 58) / 5^q rounded up
+// and fltPow5 [i] is the top 61 bits of 5^i, b being the bit length of 5^q.
+#define FLT_POW5_INV_BITS  59
+#define FLT_POW5_BITS      61
+
+static const uint64_t fltPow5Inv [32] = {
+   0x0800000000000001u, 0x0666666666666667u, 0x051EB851EB851EB9u,
+   0x04189374BC6A7EFAu, 0x068DB8BAC710CB2Au, 0x053E2D6238DA3C22u,
+   0x0431BDE82D7B634Eu, 0x06B5FCA6AF2BD216u, 0x055E63B88C230E78u,
+   0x044B82FA09B5A52Du, 0x06DF37F675EF6EAEu, 0x057F5FF85E592558u,
+   0x0465E6604B7A8447u, 0x0709709A125DA071u, 0x05A126E1A84AE6C1u,
+   0x0480EBE7B9D58567u, 0x0734ACA5F6226F0Bu, 0x05C3BD5191B525A3u,
+   0x049C97747490EAE9u, 0x0760F253EDB4AB0Eu, 0x05E72843249088D8u,
+   0x04B8ED0283A6D3E0u, 0x078E480405D7B966u, 0x060B6CD004AC9452u,
+   0x04D5F0A66A23A9DBu, 0x07BCB43D769F762Bu, 0x063090312BB2C4EFu,
+   0x04F3A68DBC8F03F3u, 0x07EC3DAF94180651u, 0x065697BFA9ACD1DAu,
+   0x051212FFBAF0A7E2u, 0x040E7599625A1FE8u };
+
+static const uint64_t fltPow5 [48] = {
+   0x1000000000000000u, 0x1400000000000000u, 0x1900000000000000u,
+   0x1F40000000000000u, 0x1388000000000000u, 0x186A000000000000u,
+   0x1E84800000000000u, 0x1312D00000000000u, 0x17D7840000000000u,
+   0x1DCD650000000000u, 0x12A05F2000000000u, 0x174876E800000000u,
+   0x1D1A94A200000000u, 0x12309CE540000000u, 0x16BCC41E90000000u,
+   0x1C6BF52634000000u, 0x11C37937E0800000u, 0x16345785D8A00000u,
+   0x1BC16D674EC80000u, 0x1158E460913D0000u, 0x15AF1D78B58C4000u,
+   0x1B1AE4D6E2EF5000u, 0x10F0CF064DD59200u, 0x152D02C7E14AF680u,
+   0x1A784379D99DB420u, 0x108B2A2C28029094u, 0x14ADF4B7320334B9u,
+   0x19D971E4FE8401E7u, 0x1027E72F1F128130u, 0x1431E0FAE6D7217Cu,
+   0x193E5939A08CE9DBu, 0x1F8DEF8808B02452u, 0x13B8B5B5056E16B3u,
+   0x18A6E32246C99C60u, 0x1ED09BEAD87C0378u, 0x13426172C74D822Bu,
+   0x1812F9CF7920E2B6u, 0x1E17B84357691B64u, 0x12CED32A16A1B11Eu,
+   0x178287F49C4A1D66u, 0x1D6329F1C35CA4BFu, 0x125DFA371A19E6F7u,
+   0x16F578C4E0A060B5u, 0x1CB2D6F618C878E3u, 0x11EFC659CF7D4B8Du,
+   0x166BB7F0435C9E71u, 0x1C06A5EC5433C60Du, 0x118427B3B4A05BC8u };
+
+// num / 10 without a divide, and num * FIVE_INV is num / 5 when the
+// product is at most FIVE_MAX, which is also the test for a multiple of 5
+#define DIV10(num)  ((uint32_t)(((uint64_t)(num) * 0xCCCCCCCDu) >> 35))
+#define FIVE_INV    0xCCCCCCCDu
+#define FIVE_MAX    0x33333333u
+
+// floor(log10(2^e)), floor(log10(5^e)) and the bit length of 5^e
+#define LOG10_POW2(e)  ((int32_t)(((uint32_t)(e) * 78913) >> 18))
+#define LOG10_POW5(e)  ((int32_t)(((uint32_t)(e) * 732923) >> 20))
+#define POW5_BITS(e)   ((int32_t)((((uint32_t)(e) * 1217359) >> 19) + 1))
+
+
+/*---------------------------------------------------------------------------
+  (m * factor) >> shift for a 64 bit factor and shift >= 32, from two
+  32 x 32 multiplies.
+---------------------------------------------------------------------------*/
+static uint32_t mulShift(uint32_t m, uint64_t factor, int32_t shift)
+   {
+   uint64_t lo, hi;
+
+   lo = (uint64_t) m * (uint32_t) factor;
+   hi = (uint64_t) m * (uint32_t) (factor >> 32);
+   return (uint32_t) (((lo >> 32) + hi) >> (shift - 32));
+   } // End mulShift()
+
+
+/*---------------------------------------------------------------------------
+  Non zero if 5^p divides num, num must not be 0.
+---------------------------------------------------------------------------*/
+static uint32_t pow5Divides(uint32_t num, int32_t p)
+   {
+   while (p > 0 && num * FIVE_INV <= FIVE_MAX)
+      {
+      num *= FIVE_INV;
+      p--;
+      }
+   return p <= 0;
+   } // End pow5Divides()
+
+
+/*---------------------------------------------------------------------------
+  Shortest decimal digits * 10^exp10 that reads back as the finite non zero
+  float with biased exponent exp and fraction frac.  This is Ryu (Adams,
+  PLDI 2018): the value and the halfway points to its neighbours are scaled
+  by one table entry each into the decimal range, then digits are dropped
+  while the two halfway points still differ, rounding the last one to even.
+---------------------------------------------------------------------------*/
+static uint32_t fltShortest(uint32_t frac, uint32_t exp, int32_t *exp10)
+   {
+   int32_t  e2, q, i, k, removed;
+   uint32_t m2, mv, mp, mm, vr, vp, vm, last, even, vmZeros, vrZeros;
+
+   if (exp == 0)
+      {
+      e2 = 1 - 127 - 23 - 2;
+      m2 = frac;
+      }
+   else
+      {
+      e2 = (int32_t) exp - 127 - 23 - 2;
+      m2 = frac | 0x800000;
+      }
+   even = (m2 & 1) == 0;
+   mv   = 4 * m2;
+   mp   = mv + 2;
+   mm   = mv - 1 - (frac != 0 || exp <= 1);      // closer below at a power of 2
+   last = 0;
+   vmZeros = 0;
+   vrZeros = 0;
+
+   if (e2 >= 0)
+      {
+      q = LOG10_POW2(e2);
+      *exp10 = q;
+      k  = FLT_POW5_INV_BITS + POW5_BITS(q) - 1;
+      i  = -e2 + q + k;
+      vr = mulShift(mv, fltPow5Inv [q], i);
+      vp = mulShift(mp, fltPow5Inv [q], i);
+      vm = mulShift(mm, fltPow5Inv [q], i);
+      if (q != 0 && DIV10(vp - 1) <= DIV10(vm))
+         {
+         k    = FLT_POW5_INV_BITS + POW5_BITS(q - 1) - 1;
+         last = mulShift(mv, fltPow5Inv [q - 1], -e2 + q - 1 + k);
+         last = last - DIV10(last) * 10;
+         }
+      if (q <= 9)
+         {
+         if (mv * FIVE_INV <= FIVE_MAX)
+            vrZeros = pow5Divides(mv, q);
+         else if (even)
+            vmZeros = pow5Divides(mm, q);
+         else
+            vp -= pow5Divides(mp, q);
+         }
+      }
+   else
+      {
+      q = LOG10_POW5(-e2);
+      *exp10 = q + e2;
+      i  = -e2 - q;
+      k  = q - (POW5_BITS(i) - FLT_POW5_BITS);
+      vr = mulShift(mv, fltPow5 [i], k);
+      vp = mulShift(mp, fltPow5 [i], k);
+      vm = mulShift(mm, fltPow5 [i], k);
+      if (q != 0 && DIV10(vp - 1) <= DIV10(vm))
+         {
+         k    = q - 1 - (POW5_BITS(i + 1) - FLT_POW5_BITS);
+         last = mulShift(mv, fltPow5 [i + 1], k);
+         last = last - DIV10(last) * 10;
+         }
+      if (q <= 1)
+         {
+         vrZeros = 1;
+         if (even)
+            vmZeros = (frac != 0 || exp <= 1);
+         else
+            vp--;
+         }
+      else if (q < 31)
+         {
+         vrZeros = (mv & ((1u << (q - 1)) - 1)) == 0;
+         }
+      }
+
+   removed = 0;
+   while (DIV10(vp) > DIV10(vm))
+      {
+      vmZeros &= vm == DIV10(vm) * 10;
+      vrZeros &= last == 0;
+      last = vr - DIV10(vr) * 10;
+      vr   = DIV10(vr);
+      vp   = DIV10(vp);
+      vm   = DIV10(vm);
+      removed++;
+      }
+   if (vmZeros)
+      {
+      while (vm == DIV10(vm) * 10)
+         {
+         vrZeros &= last == 0;
+         last = vr - DIV10(vr) * 10;
+         vr   = DIV10(vr);
+         vm   = DIV10(vm);
+         removed++;
+         }
+      }
+   if (vrZeros && last == 5 && (vr & 1) == 0)
+      last = 4;                                 // exact tie, round to even
+   *exp10 += removed;
+   return vr + ((vr == vm && (!even || !vmZeros)) || last >= 5);
+   } // End fltShortest()
+
+
+/*---------------------------------------------------------------------------
+  The shortest decimal that reads back as the IEEE single with these bits.
+  The buffer must hold FMT_FLT_LEN.  Plain notation from 0.0001 up to
+  999999999, otherwise d.dddE[-]x.  Infinities are Inf and -Inf, every NaN
+  is NaN.
+
+  3F800000  1        41520000  13.125      33D6BF95  1E-7
+  3DCCCCCD  0.1      7F7FFFFF  3.4028235E38  00000001  1E-45
+---------------------------------------------------------------------------*/
+uint32_t fmtFlt(uint32_t bits, char *buff)
+   {
+   char     digits [FMT_DEC_LEN];
+   uint32_t frac, exp, len, i;
+   int32_t  exp10, sci;
+   char    *p;
+
+   frac = bits & 0x7FFFFF;
+   exp  = (bits >> 23) & 0xFF;
+   p    = buff;
+   if (exp == 0xFF && frac != 0)
+      {
+      buff [0] = 'N';
+      buff [1] = 'a';
+      buff [2] = 'N';
+      buff [3] = 0x00;
+      return 3;
+      }
+   if (bits >> 31)
+      *p++ = '-';
+   if (exp == 0xFF)
+      {
+      *p++ = 'I';
+      *p++ = 'n';
+      *p++ = 'f';
+      *p   = 0x00;
+      return p - buff;
+      }
+   if (exp == 0 && frac == 0)
+      {
+      *p++ = '0';
+      *p   = 0x00;
+      return p - buff;
+      }
+
+   len = fmtDec(fltShortest(frac, exp, &exp10), digits);
+   sci = exp10 + (int32_t) len - 1;             // power of ten of digits [0]
+   if (sci < -4 || sci > 8)
+      {
+      *p++ = digits [0];
+      if (len > 1)
+         {
+         *p++ = '.';
+         for (i = 1; i < len; i++)
+            *p++ = digits [i];
+         }
+      *p++ = 'E';
+      if (sci < 0)
+         {
+         *p++ = '-';
+         sci  = -sci;
+         }
+      p += fmtDec(sci, p);
+      }
+   else if (sci < 0)
+      {
+      *p++ = '0';
+      *p++ = '.';
+      for (i = 1; i < (uint32_t) -sci; i++)
+         *p++ = '0';
+      for (i = 0; i < len; i++)
+         *p++ = digits [i];
+      }
+   else
+      {
+      for (i = 0; i < len; i++)
+         {
+         *p++ = digits [i];
+         if (i == (uint32_t) sci && i + 1 < len)
+            *p++ = '.';
+         }
+      for (; i <= (uint32_t) sci; i++)
+         *p++ = '0';
+      }
+   *p = 0x00;
+   return p - buff;
+   } // End fmtFlt()
@@ -0,0 +1,23 @@
+//-------------------------------------------------------------------------
+// fmt.h
+// Number formatting into a caller supplied buffer.  Each routine returns
+// the number of characters written and NUL terminates the result, so
+// several numbers can be built into one line and sent with one uartWrite().
+// 10/18/2026 - Initial version
+// 10/18/2026 - fmtFlt(), shortest round trip decimal for IEEE singles
+//-------------------------------------------------------------------------
+
+#ifndef FMT_H
+#define FMT_H
+
+#include <stdint.h>
+
+#define FMT_DEC_LEN 11                    // 4294967295 plus the NUL
+#define FMT_HEX_LEN 9                     // FFFFFFFF plus the NUL
+#define FMT_FLT_LEN 16                    // -1.23456789E-38 plus the NUL
+
+uint32_t fmtDec(uint32_t num, char *buff);
+uint32_t fmtHex(uint32_t num, char *buff);
+uint32_t fmtFlt(uint32_t bits, char *buff);
+
+#endif // FMT_H
@@ -0,0 +1,117 @@
+//-------------------------------------------------------------------------
+// frame.c
+// Binary frame encoding, decoding and CRC, see frame.h.  Shared by the
+// firmware and the host client in host/binproto.c.
+// 10/18/2026 - Initial version
+// 10/18/2026 - Unsigned end of data in frameRx()
+//-------------------------------------------------------------------------
+
+#include <stdint.h>
+#include "frame.h"
+
+// CRC-16/CCITT a nibble at a time, 0x1021 times each value of the top 4 bits
+static const uint16_t crcNibble [16] =
+   {
+   0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+   0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+   };
+
+
+/*---------------------------------------------------------------------------
+  Adds len bytes to crc, start from 0xFFFF.  "123456789" gives 0x29B1.
+---------------------------------------------------------------------------*/
+uint16_t frameCrc(uint16_t crc, const uint8_t *data, uint32_t len)
+   {
+   while (len-- > 0)
+      {
+      crc ^= (uint16_t)(*data++ << 8);
+      crc = (uint16_t)(crc << 4) ^ crcNibble [crc >> 12];
+      crc = (uint16_t)(crc << 4) ^ crcNibble [crc >> 12];
+      }
+   return crc;
+   } // End frameCrc()
+
+
+/*---------------------------------------------------------------------------
+  The little endian word at data
+---------------------------------------------------------------------------*/
+uint32_t frameWord(const uint8_t *data)
+   {
+   return data [0] | (data [1] << 8) | (data [2] << 16) | ((uint32_t)data [3] << 24);
+   } // End frameWord()
+
+
+/*---------------------------------------------------------------------------
+  Builds a frame of n words into buf, which must hold FRAME_MAX bytes, and
+  returns its length.  n is at most FRAME_DATA_MAX / 4.
+---------------------------------------------------------------------------*/
+uint32_t frameEncode(uint32_t op, uint32_t status, const uint32_t *word, uint32_t n, uint8_t *buf)
+   {
+   uint32_t len = FRAME_HEAD;
+   uint16_t crc;
+
+   buf [0] = FRAME_SYNC;
+   buf [1] = op;
+   buf [2] = status;
+   buf [3] = n * 4;
+   while (n-- > 0)
+      {
+      buf [len++] = *word;
+      buf [len++] = *word >> 8;
+      buf [len++] = *word >> 16;
+      buf [len++] = *word++ >> 24;
+      }
+   crc = frameCrc(0xFFFF, buf + 1, len - 1);
+   buf [len++] = crc;
+   buf [len++] = crc >> 8;
+   return len;
+   } // End frameEncode()
+
+
+/*---------------------------------------------------------------------------
+  Feeds one received byte to rx.  Bytes are skipped until a FRAME_SYNC, a
+  length that is too big or not whole words goes back to looking for one.
+  On FRAME_DONE op, status, len and data hold the frame until the next
+  byte; on FRAME_BAD only op is worth anything.
+---------------------------------------------------------------------------*/
+uint32_t frameRx(FRAMERX *rx, uint8_t byte)
+   {
+   uint32_t pos = rx->pos;
+   uint32_t end;                          // where the CRC starts, once len is in
+
+   if (pos == 0)
+      {
+      if (byte == FRAME_SYNC)
+         {
+         rx->crc = 0xFFFF;
+         rx->pos = 1;
+         }
+      return FRAME_MORE;
+      }
+
+   rx->pos++;
+   end = FRAME_HEAD + (uint32_t)rx->len;
+   if (pos < end || pos < FRAME_HEAD)
+      {
+      rx->crc = frameCrc(rx->crc, &byte, 1);
+      if (pos == 1)
+         rx->op = byte;
+      else if (pos == 2)
+         rx->status = byte;
+      else if (pos == 3)
+         {
+         rx->len = byte;
+         if (byte > FRAME_DATA_MAX || (byte & 3) != 0) rx->pos = 0;
+         }
+      else
+         rx->data [pos - FRAME_HEAD] = byte;
+      return FRAME_MORE;
+      }
+   if (pos == end)
+      {
+      rx->crcLo = byte;
+      return FRAME_MORE;
+      }
+   rx->pos = 0;
+   return (rx->crc == (rx->crcLo | (byte << 8))) ? FRAME_DONE : FRAME_BAD;
+   } // End frameRx()
@@ -0,0 +1,64 @@
+//-------------------------------------------------------------------------
+// frame.h
+// Binary frames for "mode bin".  Operands travel as raw 32 bit words
+// instead of 8 hex characters each and nothing is echoed, requests and
+// replies share one layout:
+//
+//   FRAME_SYNC  op  status  len  data [len]  crc lo  crc hi
+//
+// data is len / 4 little endian words.  crc is CRC-16/CCITT (0x1021, from
+// 0xFFFF) over op, status, len and data.  A request's status is 0, a
+// reply carries the request's op and the command's return code, the same
+// codes as the ASCII messages, and its result word.  Every request gets
+// exactly one reply, in order.
+// The op of a command is its parseData[] slot in parser.c.  FRAME_OP_MODE
+// with no data goes back to the ASCII command line, its reply is the last
+// frame.  "mode bin" answers with the same empty frame once binary.
+// 10/18/2026 - Initial version
+//-------------------------------------------------------------------------
+
+#ifndef FRAME_H
+#define FRAME_H
+
+#include <stdint.h>
+
+#define FRAME_SYNC        0xA5            // never in ASCII command text
+#define FRAME_HEAD        4               // sync, op, status, len
+#define FRAME_DATA_MAX    32              // 8 words
+#define FRAME_MAX         (FRAME_HEAD + FRAME_DATA_MAX + 2)
+
+// ops, parseData[] slots
+#define FRAME_OP_HEX      2
+#define FRAME_OP_FMUL     3
+#define FRAME_OP_FADD     4
+#define FRAME_OP_FENC     5
+#define FRAME_OP_FFMA     11
+#define FRAME_OP_FDEC     12
+#define FRAME_OP_MODE     16
+
+// Reply status besides the command return codes
+#define FRAME_ST_OK       0
+#define FRAME_ST_BAD_CRC  0x80            // the request was dropped
+
+// frameRx() results
+#define FRAME_MORE        0               // keep feeding bytes
+#define FRAME_DONE        1               // a good frame is in the FRAMERX
+#define FRAME_BAD         2               // a frame failed its CRC
+
+typedef struct
+   {
+   uint8_t  op;
+   uint8_t  status;
+   uint8_t  len;
+   uint8_t  data [FRAME_DATA_MAX];
+   uint8_t  crcLo;                        // first CRC byte received
+   uint16_t crc;                          // over the bytes seen so far
+   uint32_t pos;                          // bytes of the frame seen, 0 = hunting
+   } FRAMERX;
+
+uint16_t frameCrc(uint16_t crc, const uint8_t *data, uint32_t len);
+uint32_t frameEncode(uint32_t op, uint32_t status, const uint32_t *word, uint32_t n, uint8_t *buf);
+uint32_t frameRx(FRAMERX *rx, uint8_t byte);
+uint32_t frameWord(const uint8_t *data);
+
+#endif // FRAME_H
@@ -0,0 +1,211 @@
+//-------------------------------------------------------------------------
+// binproto.c
+// Host side client for the binary frame mode, see binproto.h.
+//
+//   cc -O2 -I. -Ihost -c host/binproto.c frame.c
+//
+// 10/18/2026 - Initial version
+//-------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+#include "frame.h"
+#include "binproto.h"
+
+// Commands that have a frame op, operands are 8 hex digits at most
+static const struct
+   {
+   const char *name;
+   uint32_t    op;
+   uint32_t    nOps;
+   } binCmds[] = { { "hex", FRAME_OP_HEX, 1 }, { "fmul", FRAME_OP_FMUL, 2 },
+                   { "fadd", FRAME_OP_FADD, 2 }, { "fenc", FRAME_OP_FENC, 2 },
+                   { "ffma", FRAME_OP_FFMA, 3 }, { "fdec", FRAME_OP_FDEC, 1 }, };
+
+
+/*---------------------------------------------------------------------------
+  Opens tty raw, 8N1 at baud.  Returns 0, or BIN_ERROR if the port or the
+  baud rate is no good.
+---------------------------------------------------------------------------*/
+int binOpen(BINLINK *link, const char *tty, uint32_t baud)
+   {
+   struct termios tio;
+   speed_t speed;
+
+   switch (baud)
+      {
+      case 9600:   speed = B9600;   break;
+      case 19200:  speed = B19200;  break;
+      case 38400:  speed = B38400;  break;
+      case 57600:  speed = B57600;  break;
+      case 115200: speed = B115200; break;
+      default:     return BIN_ERROR;
+      }
+   memset(link, 0, sizeof(*link));
+   link->fd = open(tty, O_RDWR | O_NOCTTY);
+   if (link->fd < 0) return BIN_ERROR;
+   if (tcgetattr(link->fd, &tio) != 0)
+      {
+      binClose(link);
+      return BIN_ERROR;
+      }
+   cfmakeraw(&tio);
+   cfsetispeed(&tio, speed);
+   cfsetospeed(&tio, speed);
+   tio.c_cflag |= CLOCAL | CREAD;
+   if (tcsetattr(link->fd, TCSANOW, &tio) != 0)
+      {
+      binClose(link);
+      return BIN_ERROR;
+      }
+   return 0;
+   } // End binOpen()
+
+
+void binClose(BINLINK *link)
+   {
+   if (link->fd >= 0) close(link->fd);
+   link->fd = -1;
+   } // End binClose()
+
+
+static int binWrite(BINLINK *link, const uint8_t *buf, uint32_t len)
+   {
+   ssize_t done;
+
+   while (len > 0)
+      {
+      done = write(link->fd, buf, len);
+      if (done <= 0) return BIN_ERROR;
+      buf += done;
+      len -= done;
+      }
+   return 0;
+   } // End binWrite()
+
+
+/*---------------------------------------------------------------------------
+  Sends one request frame of n operand words
+---------------------------------------------------------------------------*/
+int binSend(BINLINK *link, uint32_t op, const uint32_t *val, uint32_t n)
+   {
+   uint8_t buf [FRAME_MAX];
+
+   if (n > FRAME_DATA_MAX / 4) return BIN_ERROR;
+   return binWrite(link, buf, frameEncode(op, 0, val, n, buf));
+   } // End binSend()
+
+
+/*---------------------------------------------------------------------------
+  Waits for the next reply frame, skipping anything that is not a frame
+  such as the echo of "mode bin".  *op is the request's op, *result its
+  first result word, if any.  Returns the status, or BIN_ERROR after
+  BIN_TIMEOUT_MS without a reply.  A reply that fails its CRC comes back
+  as FRAME_ST_BAD_CRC, the same as a request that failed on the target.
+---------------------------------------------------------------------------*/
+int binRecv(BINLINK *link, uint32_t *op, uint32_t *result)
+   {
+   struct pollfd pfd = { link->fd, POLLIN, 0 };
+   uint32_t got;
+   ssize_t len;
+
+   for (;;)
+      {
+      while (link->inPos < link->inLen)
+         {
+         got = frameRx(&link->rx, link->in [link->inPos++]);
+         if (got == FRAME_MORE) continue;
+         *op = link->rx.op;
+         if (got == FRAME_BAD) return FRAME_ST_BAD_CRC;
+         if (link->rx.len >= 4) *result = frameWord(link->rx.data);
+         return link->rx.status;
+         }
+      if (poll(&pfd, 1, BIN_TIMEOUT_MS) <= 0) return BIN_ERROR;
+      len = read(link->fd, link->in, sizeof(link->in));
+      if (len <= 0) return BIN_ERROR;
+      link->inPos = 0;
+      link->inLen = len;
+      }
+   } // End binRecv()
+
+
+/*---------------------------------------------------------------------------
+  One request and its reply.  Returns the status or BIN_ERROR.
+---------------------------------------------------------------------------*/
+int binCall(BINLINK *link, uint32_t op, const uint32_t *val, uint32_t n, uint32_t *result)
+   {
+   uint32_t replyOp;
+   int status;
+
+   if (binSend(link, op, val, n) != 0) return BIN_ERROR;
+   status = binRecv(link, &replyOp, result);
+   if (status != BIN_ERROR && replyOp != op) return BIN_ERROR;
+   return status;
+   } // End binCall()
+
+
+/*---------------------------------------------------------------------------
+  binStart() puts a target on the command line into frame mode, the CR
+  first ends anything half typed.  binStop() puts it back.  Both wait for
+  the FRAME_OP_MODE frame that answers the switch and return 0 or
+  BIN_ERROR.
+---------------------------------------------------------------------------*/
+static int binModeReply(BINLINK *link)
+   {
+   uint32_t op, result;
+   int status;
+
+   do status = binRecv(link, &op, &result);
+   while (status != BIN_ERROR && op != FRAME_OP_MODE);
+   return (status == FRAME_ST_OK) ? 0 : BIN_ERROR;
+   } // End binModeReply()
+
+int binStart(BINLINK *link)
+   {
+   static const char cmd[] = "\rmode bin\r";
+
+   link->rx.pos = 0;
+   if (binWrite(link, (const uint8_t *)cmd, sizeof(cmd) - 1) != 0) return BIN_ERROR;
+   return binModeReply(link);
+   } // End binStart()
+
+int binStop(BINLINK *link)
+   {
+   if (binSend(link, FRAME_OP_MODE, 0, 0) != 0) return BIN_ERROR;
+   return binModeReply(link);
+   } // End binStop()
+
+
+/*---------------------------------------------------------------------------
+  Turns a command line such as "fmul 41520000 3f000000" into a request
+  frame in buf, which must hold FRAME_MAX bytes.  Returns its length, or
+  0 if the command has no frame op or its operands are not hex words.
+---------------------------------------------------------------------------*/
+uint32_t binFromText(const char *line, uint8_t *buf)
+   {
+   uint32_t val [FRAME_DATA_MAX / 4];
+   uint32_t i, n, len;
+
+   len = strcspn(line, " ");
+   for (i = 0; i < sizeof(binCmds) / sizeof(binCmds[0]); i++)
+      if (strlen(binCmds[i].name) == len && !strncmp(line, binCmds[i].name, len)) break;
+   if (i == sizeof(binCmds) / sizeof(binCmds[0])) return 0;
+
+   line += len;
+   for (n = 0; n < binCmds[i].nOps; n++)
+      {
+      line += strspn(line, " ");
+      len = strcspn(line, " ");
+      if (len == 0 || len > 8) return 0;
+      if (strspn(line, "0123456789ABCDEFabcdef") < len) return 0;
+      val[n] = strtoul(line, 0, 16);
+      line += len;
+      }
+   if (line[strspn(line, " ")] != 0) return 0;
+   return frameEncode(binCmds[i].op, 0, val, n, buf);
+   } // End binFromText()
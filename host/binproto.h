@@ -0,0 +1,46 @@
+//-------------------------------------------------------------------------
+// binproto.h
+// Host side client for the binary frame mode, see frame.h.  Works on a
+// serial port opened with binOpen(), or any descriptor placed in fd.
+//
+//   BINLINK link;
+//   uint32_t ops[2] = { 0x41520000, 0x41520000 }, z;
+//   binOpen(&link, "/dev/ttyUSB0", 57600);
+//   binStart(&link);
+//   binCall(&link, FRAME_OP_FMUL, ops, 2, &z);        z is 0x432C4400
+//   binStop(&link);
+//
+// binSend() and binRecv() keep several requests in flight, the replies
+// come back in order.
+// 10/18/2026 - Initial version
+//-------------------------------------------------------------------------
+
+#ifndef BINPROTO_H
+#define BINPROTO_H
+
+#include <stdint.h>
+#include "frame.h"
+
+#define BIN_TIMEOUT_MS  1000               // for each reply
+#define BIN_ERROR       (-1)               // no reply, or the port failed
+
+typedef struct
+   {
+   int      fd;
+   FRAMERX  rx;
+   uint8_t  in [256];                      // read but not yet decoded
+   uint32_t inPos, inLen;
+   } BINLINK;
+
+int      binOpen(BINLINK *link, const char *tty, uint32_t baud);
+void     binClose(BINLINK *link);
+int      binStart(BINLINK *link);
+int      binStop(BINLINK *link);
+
+int      binSend(BINLINK *link, uint32_t op, const uint32_t *val, uint32_t n);
+int      binRecv(BINLINK *link, uint32_t *op, uint32_t *result);
+int      binCall(BINLINK *link, uint32_t op, const uint32_t *val, uint32_t n, uint32_t *result);
+
+uint32_t binFromText(const char *line, uint8_t *buf);
+
+#endif // BINPROTO_H
@@ -0,0 +1,84 @@
+//-------------------------------------------------------------------------
+// cmpe240.h
+// Host stand-in for the course's board header, which is not part of this
+// tree.  It carries only what the host tools and the sources they build
+// use: the BCM2835 mini UART, GPIO and interrupt register addresses that
+// mmio.h hands to the simulator, the command line limits, the float and
+// parser types, and the prototypes shared across files.  -Ihost picks it
+// up; a firmware build uses the real header instead.
+// 10/18/2026 - Initial version
+//-------------------------------------------------------------------------
+
+#ifndef CMPE240_H
+#define CMPE240_H
+
+#include <stdint.h>
+
+// Command line limits
+#define MAX_PARMS         8               // parameters after the command
+#define MAX_PARM_LEN      32
+#define CMD_LINE_LEN      99
+#define ASCII_DELETE      0x7F
+#define ASCII_BSPACE      0x08
+#define DELAY_CYCLES      150
+
+// BCM2835 registers, peripherals at 0x20000000
+#define IRQ_ENABLE1       0x2000B210
+#define IRQ_DISABLE1      0x2000B21C
+#define GPFSEL1           0x20200004
+#define GPPUD             0x20200094
+#define GPPUDCLK0         0x20200098
+#define AUX_ENABLES       0x20215004
+#define AUX_MU_IO_REG     0x20215040
+#define AUX_MU_IER_REG    0x20215044
+#define AUX_MU_IIR_REG    0x20215048
+#define AUX_MU_LCR_REG    0x2021504C
+#define AUX_MU_MCR_REG    0x20215050
+#define AUX_MU_LSR_REG    0x20215054
+#define AUX_MU_CNTL_REG   0x20215060
+#define AUX_MU_BAUD_REG   0x20215068
+#define RPI_BAUD_57600    541             // 250 MHz / (8 * (541 + 1))
+
+typedef uint32_t IEEE_FLT;
+
+typedef struct
+   {
+   uint32_t real;                         // integer part, two's complement
+   uint32_t fraction;                     // binary fraction
+   } INT_FRACT;
+
+typedef struct
+   {
+   char     parameter [MAX_PARM_LEN+1];
+   uint32_t len;
+   } CMDPARM;
+
+typedef struct
+   {
+   char     *ParmCmdStr;
+   uint32_t (*callBack)(CMDPARM *parms);
+   uint32_t NumParms;                     // including the command word
+   uint32_t MaxParmLen;
+   uint32_t MinParmLen;
+   uint32_t EvenHexOnly;
+   } PARSEDATA;
+
+IEEE_FLT IeeeMult(IEEE_FLT a, IEEE_FLT b);
+IEEE_FLT IeeeAdd(IEEE_FLT a, IEEE_FLT b);
+IEEE_FLT IeeeEncode(INT_FRACT a);
+
+void     uart_init(void);
+void     echoBuffer(void);
+void     uartPutC(const char character);
+void     uartPutStr(const char *str);
+void     uartHexStrings(uint32_t data);
+void     decStr(uint32_t num, uint8_t *buff);
+uint32_t parseCmdLine(char *InCmdLine);
+char    *parseSingleItem(char *inStringP, CMDPARM *singleParm);
+uint32_t verifyHex(const char *string);
+uint32_t char2Hex(const char *string);
+uint32_t countParms(CMDPARM *parms);
+uint32_t typeCall(CMDPARM *parms);
+uint32_t sizeCall(CMDPARM *parms);
+
+#endif // CMPE240_H
@@ -0,0 +1,96 @@
+//-------------------------------------------------------------------------
+// diskimg.c
+// hddDev for host builds, a raw .img file such as dd makes of an SD card
+// or a partition.  Opening another image unmounts the old one.
+// diskImgOpen() reads it with pread(), diskImgMap() maps it and gives fat.c
+// pointers into the mapping, nothing is read until a page is touched.
+// 10/18/2026 - Initial version
+// 10/18/2026 - diskImgMap()
+//-------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "fat.h"
+#include "diskimg.h"
+
+static int      imgFd = -1;
+static uint8_t *imgMem;                   // the mapping, 0 if read
+static size_t   imgSectors;
+
+static uint32_t imgRead(void *ctx, uint32_t lba, uint32_t count, uint8_t *buf)
+   {
+   ssize_t got;
+
+   (void)ctx;
+   if (imgMem != 0)
+      {
+      if (lba >= imgSectors) return 0;
+      if (count > imgSectors - lba) count = imgSectors - lba;
+      memcpy(buf, imgMem + (size_t)lba * FAT_SECTOR, (size_t)count * FAT_SECTOR);
+      return count;
+      }
+   got = pread(imgFd, buf, (size_t)count * FAT_SECTOR, (off_t)lba * FAT_SECTOR);
+   return (got > 0) ? got / FAT_SECTOR : 0;
+   } // End imgRead()
+
+static const uint8_t *imgMap(void *ctx, uint32_t lba, uint32_t count)
+   {
+   (void)ctx;
+   if (lba >= imgSectors || count > imgSectors - lba) return 0;
+   return imgMem + (size_t)lba * FAT_SECTOR;
+   } // End imgMap()
+
+SECTORDEV hddDev = { imgRead, 0, 0 };
+
+
+/*---------------------------------------------------------------------------
+  Makes path the disk behind hddDev, returns 0 or -1 if it can't be opened
+---------------------------------------------------------------------------*/
+int diskImgOpen(const char *path)
+   {
+   diskImgClose();
+   imgFd = open(path, O_RDONLY);
+   return (imgFd < 0) ? -1 : 0;
+   } // End diskImgOpen()
+
+/*---------------------------------------------------------------------------
+  The same but mapped, hddDev gets map.  Returns 0, or -1 if path can't be
+  opened or mapped.
+---------------------------------------------------------------------------*/
+int diskImgMap(const char *path)
+   {
+   struct stat st;
+   void *mem;
+
+   if (diskImgOpen(path) != 0) return -1;
+   if (fstat(imgFd, &st) != 0 || st.st_size < FAT_SECTOR)
+      {
+      diskImgClose();
+      return -1;
+      }
+   mem = mmap(0, st.st_size, PROT_READ, MAP_SHARED, imgFd, 0);
+   if (mem == MAP_FAILED)
+      {
+      diskImgClose();
+      return -1;
+      }
+   imgMem     = mem;
+   imgSectors = st.st_size / FAT_SECTOR;
+   hddDev.map = imgMap;
+   return 0;
+   } // End diskImgMap()
+
+void diskImgClose(void)
+   {
+   fatUnmount();
+   if (imgMem != 0) munmap(imgMem, imgSectors * FAT_SECTOR);
+   imgMem     = 0;
+   imgSectors = 0;
+   hddDev.map = 0;
+   if (imgFd >= 0) close(imgFd);
+   imgFd = -1;
+   } // End diskImgClose()
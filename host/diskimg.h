@@ -0,0 +1,18 @@
+//-------------------------------------------------------------------------
+// diskimg.h
+// hddDev for host builds, sectors come from a raw disk image file, read
+// or mapped
+// 10/18/2026 - Initial version
+// 10/18/2026 - diskImgMap()
+//-------------------------------------------------------------------------
+
+#ifndef DISKIMG_H
+#define DISKIMG_H
+
+#include <stdint.h>
+
+int      diskImgOpen(const char *path);
+int      diskImgMap(const char *path);
+void     diskImgClose(void);
+
+#endif // DISKIMG_H
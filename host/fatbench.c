@@ -0,0 +1,591 @@
+//-------------------------------------------------------------------------
+// fatbench.c
+// Test images for fat.c and the time the type and size commands spend in
+// it.
+//   make    writes a FAT16 or FAT32 image of count files F0000.TXT ...
+//           behind an MBR, or without one with -s.  Files are written in
+//           pairs a cluster at a time so half the chains are fragmented,
+//           and the root directory has long name and deleted entries.
+//           BIG.DAT after them is KB kilobytes, 4096 unless -b says.
+//   bench   mounts an image from make, looks every file up the way size
+//           does, reads the first and last 100 bytes of every file the
+//           way type does and every file whole the way type -all does,
+//           checking sizes and contents, then prints latency percentiles
+//           and sector reads and maps for each, the same for BIG.DAT.  Then
+//           size and type again and again on a few files, the way a
+//           session goes, and the sector cache and directory index
+//           counts.  -m maps the image in place of reading it, BIG.DAT
+//           is then also sent through fatMap() with no copy.
+//
+//   cc -O2 -I. -Ihost -o fatbench host/fatbench.c host/diskimg.c fat.c
+//   (add -DFAT_CACHE_DISABLE or -DFAT_INDEX_DISABLE to compare without
+//   the cache or the directory index)
+//   fatbench make image [-t 16|32] [-n count] [-b KB] [-s]
+//   fatbench bench image [-n count] [-m]
+//
+// For the two backends on a 1 GB image:
+//   fatbench make big.img -t 32 -b 1048576
+//   fatbench bench big.img; fatbench bench big.img -m
+//
+// 10/18/2026 - Initial version
+// 10/18/2026 - BIG.DAT, type reads the two ends, all reads the lot
+// 10/18/2026 - Repeats on a few files and the sector cache counters
+// 10/18/2026 - Directory index counters, fatInvalidate() check
+// 10/18/2026 - -m for the mapped backend, BIG.DAT streamed in chunks
+// 10/18/2026 - Map calls in their own column, apart from reads
+//-------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "fat.h"
+#include "diskimg.h"
+
+#define PART_START   2048                 // MBR gap, as SD cards have
+#define MAX_SIZE     20000
+#define BIG_FILE     10000                // fileByte() number of BIG.DAT
+#define TYPE_SHOW    100                  // bytes type shows from each end
+#define HOT_FILES    6                    // the few files of the repeat pass
+#define CHUNK        2048                 // what type -all reads at a time
+
+
+/*---------------------------------------------------------------------------
+  File i's size and contents, so bench can check what it reads.  Every
+  50th file is empty and the next one exactly 3 clusters of 2 KB.
+---------------------------------------------------------------------------*/
+static uint32_t fileSize(uint32_t i)
+   {
+   if (i % 50 == 0) return 0;
+   if (i % 50 == 1) return 3 * 2048;
+   return (i * 2654435761u >> 12) % MAX_SIZE + 1;
+   } // End fileSize()
+
+static uint8_t fileByte(uint32_t i, uint32_t off)
+   {
+   return (off % 64 == 63) ? '\n' : 'A' + (i * 7 + off) % 26;
+   } // End fileByte()
+
+static double nowNs(void)
+   {
+   struct timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return ts.tv_sec * 1e9 + ts.tv_nsec;
+   } // End nowNs()
+
+static void put16(uint8_t *p, uint32_t v)
+   {
+   p [0] = v;
+   p [1] = v >> 8;
+   } // End put16()
+
+static void put32(uint8_t *p, uint32_t v)
+   {
+   put16(p, v);
+   put16(p + 2, v >> 16);
+   } // End put32()
+
+
+/*---------------------------------------------------------------------------
+  The image being made, all in memory until it is written out
+---------------------------------------------------------------------------*/
+static struct
+   {
+   uint8_t  *disk;
+   uint32_t  type, spc, part, reserved;
+   uint32_t  fatSize, rootEntries, rootSectors, dataStart, clusters;
+   uint32_t *fat;
+   uint32_t  next;                        // next free cluster
+   } img;
+
+static uint8_t *clusterPtr(uint32_t cluster)
+   {
+   return img.disk + (size_t)(img.dataStart + (cluster - 2) * img.spc) * FAT_SECTOR;
+   } // End clusterPtr()
+
+static uint32_t clusterAlloc(uint32_t prev)
+   {
+   uint32_t c = img.next++;
+
+   img.fat [c] = 0x0FFFFFFF;
+   if (prev) img.fat [prev] = c;
+   return c;
+   } // End clusterAlloc()
+
+
+/*---------------------------------------------------------------------------
+  Directory entries, an 8.3 entry and the long name entry that goes with it
+---------------------------------------------------------------------------*/
+static void dirEntry(uint8_t *d, const char *name11, uint32_t attr, uint32_t cluster, uint32_t size)
+   {
+   memcpy(d, name11, 11);
+   d [11] = attr;
+   put16(d + 20, cluster >> 16);
+   put16(d + 22, 0x6000);                  // 12:00
+   put16(d + 24, (46 << 9) | (10 << 5) | 18);
+   put16(d + 26, cluster);
+   put32(d + 28, size);
+   } // End dirEntry()
+
+static void longEntry(uint8_t *d, const char *name, const char *name11)
+   {
+   static const uint8_t at [13] = { 1, 3, 5, 7, 9, 14, 16, 18, 20, 22, 24, 28, 30 };
+   uint8_t sum = 0;
+   uint32_t i, len = strlen(name);
+
+   for (i = 0; i < 11; i++) sum = ((sum & 1) << 7) + (sum >> 1) + (uint8_t)name11 [i];
+   memset(d, 0, 32);
+   d [0]  = 0x41;                         // last and only part
+   d [11] = 0x0F;
+   d [13] = sum;
+   for (i = 0; i < 13; i++) put16(d + at [i], i < len ? (uint8_t)name [i] : (i == len ? 0 : 0xFFFF));
+   } // End longEntry()
+
+
+static int make(const char *path, uint32_t type, uint32_t count, uint32_t big, uint32_t bare)
+   {
+   uint32_t clusterBytes, need, i, j, c, s;
+   uint32_t first [2], last [2], left [2], off [2];
+   uint32_t entries, rootClusters = 0, total, fatStart;
+   uint8_t *dir, *d, *p;
+   char name11 [12], lfn [16];
+   size_t bytes;
+   FILE *out;
+
+   memset(&img, 0, sizeof(img));
+   img.type     = type;
+   img.spc      = (type == 16) ? 4 : 1;
+   img.reserved = (type == 16) ? 1 : 32;
+   img.part     = bare ? 0 : PART_START;
+   clusterBytes = img.spc * FAT_SECTOR;
+
+   // Label, every file, a long name for every third, a deleted entry
+   // before every seventh, BIG.DAT and the end marker
+   entries = 2 + count + count / 3 + count / 7 + 3;
+   if (type == 16)
+      {
+      img.rootEntries = (entries + 15) & ~15u;
+      img.rootSectors = img.rootEntries * 32 / FAT_SECTOR;
+      }
+   else
+      rootClusters = (entries * 32 + clusterBytes - 1) / clusterBytes;
+
+   need = rootClusters + 64;
+   for (i = 0; i < count; i++) need += (fileSize(i) + clusterBytes - 1) / clusterBytes;
+   need += (big + clusterBytes - 1) / clusterBytes;
+   img.clusters = need;
+   if (type == 16 && img.clusters < 4200) img.clusters = 4200;
+   if (type == 32 && img.clusters < 66000) img.clusters = 66000;
+   if (type == 16 && img.clusters >= 65525)
+      {
+      fprintf(stderr, "too many files for FAT16\n");
+      return 1;
+      }
+   img.fatSize   = ((img.clusters + 2) * (type / 8) + FAT_SECTOR - 1) / FAT_SECTOR;
+   fatStart      = img.part + img.reserved;
+   img.dataStart = fatStart + 2 * img.fatSize + img.rootSectors;
+   total         = img.reserved + 2 * img.fatSize + img.rootSectors + img.clusters * img.spc;
+   bytes         = (size_t)(img.part + total) * FAT_SECTOR;
+   img.disk      = calloc(bytes, 1);
+   img.fat       = calloc(img.clusters + 2, sizeof(uint32_t));
+   img.fat [0]   = 0x0FFFFFF8;
+   img.fat [1]   = 0x0FFFFFFF;
+   img.next      = 2;
+
+   // MBR
+   if (img.part)
+      {
+      p = img.disk + 446;
+      p [4] = (type == 16) ? 0x0E : 0x0C;
+      put32(p + 8, img.part);
+      put32(p + 12, total);
+      img.disk [510] = 0x55;
+      img.disk [511] = 0xAA;
+      }
+
+   // Boot sector
+   p = img.disk + (size_t)img.part * FAT_SECTOR;
+   memcpy(p, "\xEB\x3C\x90MSWIN4.1", 11);
+   put16(p + 11, FAT_SECTOR);
+   p [13] = img.spc;
+   put16(p + 14, img.reserved);
+   p [16] = 2;
+   put16(p + 17, img.rootEntries);
+   if (total < 65536) put16(p + 19, total); else put32(p + 32, total);
+   p [21] = 0xF8;
+   put16(p + 24, 63);
+   put16(p + 26, 255);
+   put32(p + 28, img.part);
+   if (type == 16)
+      {
+      put16(p + 22, img.fatSize);
+      p [36] = 0x80;
+      p [38] = 0x29;
+      memcpy(p + 43, "FATBENCH   FAT16   ", 19);
+      }
+   else
+      {
+      put32(p + 36, img.fatSize);
+      put32(p + 44, 2);
+      put16(p + 48, 1);
+      put16(p + 50, 6);
+      p [64] = 0x80;
+      p [66] = 0x29;
+      memcpy(p + 71, "FATBENCH   FAT32   ", 19);
+      }
+   p [510] = 0x55;
+   p [511] = 0xAA;
+
+   // The FAT32 root directory chain comes first
+   dir = calloc(entries, 32);
+   for (i = 0, c = 0; i < rootClusters; i++) c = clusterAlloc(c);
+
+   // Files in pairs, a cluster to each in turn
+   d = dir;
+   dirEntry(d, "FATBENCH   ", 0x08, 0, 0);
+   d += 32;
+   for (i = 0; i < count; i += 2)
+      {
+      for (j = 0; j < 2; j++)
+         {
+         first [j] = last [j] = off [j] = 0;
+         left [j]  = (i + j < count) ? fileSize(i + j) : 0;
+         }
+      while (left [0] || left [1])
+         for (j = 0; j < 2; j++)
+            {
+            if (left [j] == 0) continue;
+            last [j] = clusterAlloc(last [j]);
+            if (first [j] == 0) first [j] = last [j];
+            for (s = 0; s < clusterBytes && left [j]; s++, left [j]--, off [j]++)
+               clusterPtr(last [j]) [s] = fileByte(i + j, off [j]);
+            }
+      for (j = 0; j < 2 && i + j < count; j++)
+         {
+         snprintf(name11, sizeof(name11), "F%04u   TXT", i + j);
+         if ((i + j) % 7 == 3)
+            {
+            dirEntry(d, "\xE5OLD    TXT", 0x20, 0, 0);
+            d += 32;
+            }
+         if ((i + j) % 3 == 0)
+            {
+            snprintf(lfn, sizeof(lfn), "file-%04u.txt", i + j);
+            longEntry(d, lfn, name11);
+            d += 32;
+            }
+         dirEntry(d, name11, 0x20, first [j], fileSize(i + j));
+         d += 32;
+         }
+      }
+
+   // BIG.DAT in one piece
+   c = first [0] = off [0] = 0;
+   while (off [0] < big)
+      {
+      c = clusterAlloc(c);
+      if (first [0] == 0) first [0] = c;
+      for (s = 0; s < clusterBytes && off [0] < big; s++, off [0]++)
+         clusterPtr(c) [s] = fileByte(BIG_FILE, off [0]);
+      }
+   dirEntry(d, "BIG     DAT", 0x20, first [0], big);
+
+   // Root directory, both FATs, then out to the file
+   if (type == 16)
+      memcpy(img.disk + (size_t)(fatStart + 2 * img.fatSize) * FAT_SECTOR, dir, entries * 32);
+   else
+      for (i = 0, c = 2; i < rootClusters; i++, c++)
+         memcpy(clusterPtr(c), dir + i * clusterBytes, clusterBytes);
+   for (i = 0; i < img.clusters + 2; i++)
+      for (j = 0; j < 2; j++)
+         {
+         p = img.disk + (size_t)(fatStart + j * img.fatSize) * FAT_SECTOR;
+         if (type == 16)
+            put16(p + 2 * i, img.fat [i] >= 0x0FFFFFF8 ? (img.fat [i] & 0xFFFF) : img.fat [i]);
+         else
+            put32(p + 4 * i, img.fat [i]);
+         }
+
+   out = fopen(path, "wb");
+   if (!out || fwrite(img.disk, 1, bytes, out) != bytes || fclose(out) != 0)
+      {
+      perror(path);
+      return 1;
+      }
+   printf("%s: FAT%u, %u files, %u clusters of %u bytes, %s\n", path, type, count,
+          img.clusters, clusterBytes, img.part ? "MBR" : "no MBR");
+   free(dir);
+   free(img.fat);
+   free(img.disk);
+   return 0;
+   } // End make()
+
+
+/*---------------------------------------------------------------------------
+  Latency summary of n samples in ns
+---------------------------------------------------------------------------*/
+static int cmpDouble(const void *a, const void *b)
+   {
+   double x = *(const double *)a, y = *(const double *)b;
+   return (x > y) - (x < y);
+   } // End cmpDouble()
+
+static void report(const char *what, double *ns, uint32_t n, uint32_t reads, uint32_t sectors,
+                   uint32_t maps)
+   {
+   double sum = 0;
+   uint32_t i;
+
+   for (i = 0; i < n; i++) sum += ns [i];
+   qsort(ns, n, sizeof(double), cmpDouble);
+   printf("%-6s p50 %8.2f us  p99 %8.2f us  mean %8.2f us  %6.1f reads  %7.1f sectors  %6.1f maps\n",
+          what, ns [n / 2] / 1e3, ns [(uint32_t)(n * 0.99)] / 1e3, sum / n / 1e3,
+          (double)reads / n, (double)sectors / n, (double)maps / n);
+   } // End report()
+
+
+/*---------------------------------------------------------------------------
+  What type does, the first TYPE_SHOW bytes into data, then the last
+  TYPE_SHOW after them, or a small file whole.  Returns the file size or
+  -1.  checkEnds() and checkAll() compare with file i and return 1 if it
+  is wrong.
+---------------------------------------------------------------------------*/
+static uint32_t typeEnds(const char *name, uint32_t len, uint8_t *data)
+   {
+   FATFILE file;
+
+   if (fatOpen(name, len, &file) != FAT_OK) return (uint32_t)-1;
+   if (file.size <= 2 * TYPE_SHOW)
+      fatRead(&file, data, file.size);
+   else
+      {
+      fatRead(&file, data, TYPE_SHOW);
+      fatSeek(&file, file.size - TYPE_SHOW);
+      fatRead(&file, data + TYPE_SHOW, TYPE_SHOW);
+      }
+   return (file.err == FAT_OK) ? file.size : (uint32_t)-1;
+   } // End typeEnds()
+
+static uint32_t checkAll(uint32_t i, uint32_t len, const uint8_t *data)
+   {
+   uint32_t k;
+
+   if (i != BIG_FILE && len != fileSize(i)) return 1;
+   for (k = 0; k < len; k++)
+      if (data [k] != fileByte(i, k)) return 1;
+   return 0;
+   } // End checkAll()
+
+static uint32_t checkEnds(uint32_t i, uint32_t len, const uint8_t *data)
+   {
+   uint32_t k;
+
+   if (len <= 2 * TYPE_SHOW || (i != BIG_FILE && len != fileSize(i))) return checkAll(i, len, data);
+   for (k = 0; k < TYPE_SHOW; k++)
+      if (data [k] != fileByte(i, k) ||
+          data [TYPE_SHOW + k] != fileByte(i, len - TYPE_SHOW + k)) return 1;
+   return 0;
+   } // End checkEnds()
+
+
+/*---------------------------------------------------------------------------
+  What the all passes do with the bytes, so every one is looked at
+---------------------------------------------------------------------------*/
+static uint64_t bigSum(const uint8_t *data, uint32_t len)
+   {
+   uint64_t sum = 0;
+
+   while (len--) sum += *data++;
+   return sum;
+   } // End bigSum()
+
+
+static int bench(const char *path, uint32_t count, uint32_t mapped)
+   {
+   static uint8_t data [MAX_SIZE + FAT_SECTOR];
+   double *ns = calloc(count, sizeof(double));
+   uint32_t *order = calloc(count, sizeof(uint32_t));
+   uint32_t i, k, t, len, bad = 0, reads, sectors, maps;
+   uint64_t sum, got;
+   const uint8_t *p;
+   char name [16];
+   FATDIRENT entry;
+   FATFILE file;
+   double t0;
+
+   t0 = nowNs();
+   if ((mapped ? diskImgMap(path) : diskImgOpen(path)) != 0)
+      {
+      perror(path);
+      return 1;
+      }
+   if (fatMount(&hddDev) != FAT_OK)
+      {
+      fprintf(stderr, "%s: no FAT volume\n", path);
+      return 1;
+      }
+   printf("%s: FAT%u, %s and mounted in %.1f us, %u sector reads, %u maps\n", path,
+          fatType(), mapped ? "mapped" : "opened", (nowNs() - t0) / 1e3, fatStats.devReads,
+          fatStats.devMaps);
+
+   // Random order, the same every run
+   for (i = 0; i < count; i++) order [i] = i;
+   for (i = count - 1, k = 12345; i > 0; i--)
+      {
+      k = k * 1103515245 + 12345;
+      t = order [i];
+      order [i] = order [(k >> 8) % (i + 1)];
+      order [(k >> 8) % (i + 1)] = t;
+      }
+
+   // size: one lookup
+   reads = fatStats.devReads;
+   sectors = fatStats.devSectors;
+   maps = fatStats.devMaps;
+   for (i = 0; i < count; i++)
+      {
+      len = snprintf(name, sizeof(name), "F%04u.TXT", order [i]);
+      t0 = nowNs();
+      if (searchDir(name, len, &entry) != FAT_OK || entry.size != fileSize(order [i])) bad++;
+      ns [i] = nowNs() - t0;
+      }
+   report("size", ns, count, fatStats.devReads - reads, fatStats.devSectors - sectors,
+          fatStats.devMaps - maps);
+
+   // type: open, the first 100 bytes, seek and the last 100
+   reads = fatStats.devReads;
+   sectors = fatStats.devSectors;
+   maps = fatStats.devMaps;
+   for (i = 0; i < count; i++)
+      {
+      len = snprintf(name, sizeof(name), "F%04u.TXT", order [i]);
+      t0 = nowNs();
+      len = typeEnds(name, len, data);
+      ns [i] = nowNs() - t0;
+      bad += checkEnds(order [i], len, data);
+      }
+   report("type", ns, count, fatStats.devReads - reads, fatStats.devSectors - sectors,
+          fatStats.devMaps - maps);
+
+   // type -all: open and read the whole file
+   reads = fatStats.devReads;
+   sectors = fatStats.devSectors;
+   maps = fatStats.devMaps;
+   for (i = 0; i < count; i++)
+      {
+      len = snprintf(name, sizeof(name), "F%04u.TXT", order [i]);
+      t0 = nowNs();
+      len = (fatOpen(name, len, &file) == FAT_OK) ? fatRead(&file, data, sizeof(data)) : (uint32_t)-1;
+      ns [i] = nowNs() - t0;
+      bad += checkAll(order [i], len, data);
+      }
+   report("all", ns, count, fatStats.devReads - reads, fatStats.devSectors - sectors,
+          fatStats.devMaps - maps);
+
+   // BIG.DAT, if the image has it, the two ends and then all of it the
+   // way type -all does, summed as it goes
+   if (searchDir("BIG.DAT", 7, &entry) == FAT_OK && entry.size > 2 * TYPE_SHOW)
+      {
+      reads = fatStats.devReads;
+      sectors = fatStats.devSectors;
+      maps = fatStats.devMaps;
+      t0 = nowNs();
+      len = typeEnds("BIG.DAT", 7, data);
+      ns [0] = nowNs() - t0;
+      report("typeB", ns, 1, fatStats.devReads - reads, fatStats.devSectors - sectors,
+             fatStats.devMaps - maps);
+      bad += (len != entry.size) || checkEnds(BIG_FILE, len, data);
+
+      for (k = 0, sum = 0; k < entry.size; k++) sum += fileByte(BIG_FILE, k);
+      reads = fatStats.devReads;
+      sectors = fatStats.devSectors;
+      maps = fatStats.devMaps;
+      t0 = nowNs();
+      got = 0;
+      if (fatOpen("BIG.DAT", 7, &file) == FAT_OK)
+         while ((len = fatRead(&file, data, CHUNK)) != 0) got += bigSum(data, len);
+      ns [0] = nowNs() - t0;
+      report("allB", ns, 1, fatStats.devReads - reads, fatStats.devSectors - sectors,
+             fatStats.devMaps - maps);
+      printf("       %.0f MB/s\n", entry.size / (ns [0] / 1e3));
+      bad += (got != sum);
+
+      if (mapped)
+         {
+         reads = fatStats.devReads;
+         sectors = fatStats.devSectors;
+         maps = fatStats.devMaps;
+         t0 = nowNs();
+         got = 0;
+         if (fatOpen("BIG.DAT", 7, &file) == FAT_OK)
+            while ((p = fatMap(&file, entry.size, &len)) != 0) got += bigSum(p, len);
+         ns [0] = nowNs() - t0;
+         report("mapB", ns, 1, fatStats.devReads - reads, fatStats.devSectors - sectors,
+                fatStats.devMaps - maps);
+         printf("       %.0f MB/s\n", entry.size / (ns [0] / 1e3));
+         bad += (got != sum) || file.err != FAT_OK;
+         }
+      }
+
+   // Repeats: size then type on one of a few files, chosen at random
+   reads = fatStats.devReads;
+   sectors = fatStats.devSectors;
+   maps = fatStats.devMaps;
+   for (i = 0; i < count; i++)
+      {
+      k = k * 1103515245 + 12345;
+      t = order [(k >> 8) % HOT_FILES];
+      len = snprintf(name, sizeof(name), "F%04u.TXT", t);
+      t0 = nowNs();
+      if (searchDir(name, len, &entry) != FAT_OK || entry.size != fileSize(t)) bad++;
+      len = typeEnds(name, len, data);
+      ns [i] = nowNs() - t0;
+      bad += checkEnds(t, len, data);
+      }
+   report("repeat", ns, count, fatStats.devReads - reads, fatStats.devSectors - sectors,
+          fatStats.devMaps - maps);
+   printf("cache  fat %u/%u  dir %u/%u  data %u/%u hits/misses, %u extent hits\n",
+          fatStats.fat.hits, fatStats.fat.misses, fatStats.dir.hits, fatStats.dir.misses,
+          fatStats.data.hits, fatStats.data.misses, fatStats.extentHits);
+   printf("index  %u hits, %u builds\n", fatStats.indexHits, fatStats.indexBuilds);
+
+   // A new generation builds the index again, and still finds the files
+   k = fatStats.indexBuilds;
+   fatInvalidate();
+   if (searchDir("F0001.TXT", 9, &entry) != FAT_OK || entry.size != fileSize(1)) bad++;
+   if (fatStats.indexBuilds != k && fatStats.indexBuilds != k + 1) bad++;
+
+   // Names that are not there, and not valid
+   if (searchDir("NOSUCH.TXT", 10, &entry) != FAT_NOT_FOUND) bad++;
+   if (searchDir("f0001.txt", 9, &entry) != FAT_BAD_NAME) bad++;
+   if (searchDir("OLD.TXT", 7, &entry) != FAT_NOT_FOUND) bad++;
+   printf("%u files checked, %u bad\n", count, bad);
+   diskImgClose();
+   free(ns);
+   free(order);
+   return bad != 0;
+   } // End bench()
+
+
+int main(int argc, char **argv)
+   {
+   uint32_t count = 1000, type = 16, big = 4096, bare = 0, mapped = 0;
+   int i;
+
+   for (i = 3; i < argc; i++)
+      {
+      if (!strcmp(argv[i], "-n") && i + 1 < argc) count = strtoul(argv[++i], 0, 0);
+      else if (!strcmp(argv[i], "-t") && i + 1 < argc) type = strtoul(argv[++i], 0, 0);
+      else if (!strcmp(argv[i], "-b") && i + 1 < argc) big = strtoul(argv[++i], 0, 0);
+      else if (!strcmp(argv[i], "-s")) bare = 1;
+      else if (!strcmp(argv[i], "-m")) mapped = 1;
+      }
+   if (argc >= 3 && !strcmp(argv[1], "make") && count && count <= 10000 && (type == 16 || type == 32) && big <= 2097152)
+      return make(argv[2], type, count, big * 1024, bare);
+   if (argc >= 3 && !strcmp(argv[1], "bench") && count)
+      return bench(argv[2], count, mapped);
+   fprintf(stderr, "usage: %s make image [-t 16|32] [-n count] [-b KB] [-s]\n"
+           "       %s bench image [-n count] [-m]\n", argv[0], argv[0]);
+   return 1;
+   } // End main()
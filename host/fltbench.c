@@ -0,0 +1,706 @@
+//-------------------------------------------------------------------------
+// fltbench.c
+// Checks and times fmtFlt(), the shortest round trip decimal behind the
+// fdec command and "fout dec", and IeeeParse(), decimal input for fparse
+// and the float commands.
+//   check   every one of the 2^32 bit patterns: the text must read back
+//           through strtof() as the same bits, no decimal with one digit
+//           less may do so, and a negative is its positive with a '-'
+//   bench   fmtFlt() against the naive conversion, printf("%.*e") with one
+//           more digit at a time until strtof() reads the same bits back
+//   parse   IeeeParse() against strtof() on random floats printed with 1 to
+//           12 digits and on halfway points printed with up to 140 digits
+//   pbench  IeeeParse() against strtof() on shortest decimals
+//   arith   IeeeMult(), IeeeAdd() and IeeeEncode() against the host's float
+//           arithmetic on random operands, a quarter of them any bit
+//           pattern and the rest steered at the hard spots: exponents at
+//           the ends of the range, near equal operands that cancel,
+//           products that land subnormal or overflow, and values with
+//           all ones or a single one in the fraction.  The batch kernels
+//           must give the same bits as the scalar routines.
+//   aall    every one of the 2^32 bit patterns as a, times and plus a
+//           fixed set of b, and every 32 bit real and fraction for
+//           IeeeEncode(), about half an hour on one core
+//   abench  ns and, on x86, TSC ticks per operation for the scalar and
+//           batch routines against the host's float code
+//   fma     IeeeFma() against fmaf() on random operands, cancellation,
+//           subnormal results and exact ties at the rounding boundary
+// Any NaN matches any NaN, the host's choice of NaN payload is not the
+// one ieee.c documents.  With -DHOST_SIM the batch kernels take their SSE
+// path.
+//
+//   cc -O2 -I. -Ihost -o fltbench host/fltbench.c fmt.c ieee.c -lm
+//   fltbench check | bench | parse | pbench [-n count]
+//   fltbench arith | aall | abench | fma [-n count]
+//
+// 10/18/2026 - Initial version
+// 10/18/2026 - parse and pbench
+// 10/18/2026 - arith, aall and abench
+// 10/18/2026 - fma
+// 10/18/2026 - cmpe240.h from host/ on the build line
+//-------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#include "cmpe240.h"
+#include "fmt.h"
+#include "ieee.h"
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_TSC 1
+#endif
+
+#define MAX_SHOWN 10                      // mismatches printed per check
+
+static uint32_t fltBits(float f)
+   {
+   uint32_t bits;
+   memcpy(&bits, &f, 4);
+   return bits;
+   } // End fltBits()
+
+static float bitsFlt(uint32_t bits)
+   {
+   float f;
+   memcpy(&f, &bits, 4);
+   return f;
+   } // End bitsFlt()
+
+static double nowSecs(void)
+   {
+   struct timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return ts.tv_sec + ts.tv_nsec / 1e9;
+   } // End nowSecs()
+
+static uint64_t nowTicks(void)
+   {
+#ifdef HAVE_TSC
+   return __rdtsc();
+#else
+   return 0;
+#endif
+   } // End nowTicks()
+
+
+/*---------------------------------------------------------------------------
+  Splits fmtFlt() text into its significant digits and the power of ten of
+  the last one, 1.25E-3 gives 125 and -5.  Returns the digit count.
+---------------------------------------------------------------------------*/
+static uint32_t splitDec(const char *s, uint32_t *digits, int32_t *exp10)
+   {
+   uint32_t n = 0, frac = 0, seen = 0;
+
+   *digits = 0;
+   *exp10  = 0;
+   for (; *s && *s != 'E'; s++)
+      {
+      if (*s == '.') { seen = 1; continue; }
+      *digits = *digits * 10 + (*s - '0');
+      if (*digits) n++;
+      frac += seen;
+      }
+   if (*s == 'E') *exp10 = atoi(s + 1);
+   *exp10 -= frac;
+   while (*digits && *digits % 10 == 0)        // 100000000 is one digit
+      {
+      *digits /= 10;
+      *exp10  += 1;
+      n--;
+      }
+   return n;
+   } // End splitDec()
+
+
+/*---------------------------------------------------------------------------
+  Non zero if digits * 10^exp10 reads back as bits.
+---------------------------------------------------------------------------*/
+static uint32_t readsBack(uint32_t digits, int32_t exp10, uint32_t bits)
+   {
+   char text[32];
+
+   snprintf(text, sizeof(text), "%ue%d", digits, exp10);
+   return fltBits(strtof(text, 0)) == bits;
+   } // End readsBack()
+
+
+static uint32_t xorshift(void)
+   {
+   static uint32_t x = 0x12345678;
+
+   x ^= x << 13;
+   x ^= x >> 17;
+   x ^= x << 5;
+   return x;
+   } // End xorshift()
+
+static uint32_t randomFinite(void)
+   {
+   uint32_t bits;
+
+   do bits = xorshift(); while ((bits & 0x7F800000) == 0x7F800000);
+   return bits;
+   } // End randomFinite()
+
+
+static int check(void)
+   {
+   char pos[FMT_FLT_LEN], neg[FMT_FLT_LEN];
+   uint32_t bits, digits, n;
+   uint64_t bad = 0, done = 0;
+   int32_t exp10;
+
+   for (bits = 0; bits < 0x80000000u; bits++)
+      {
+      fmtFlt(bits, pos);
+      fmtFlt(bits | 0x80000000u, neg);
+      done += 2;
+      if ((bits & 0x7FFFFFFF) > 0x7F800000)
+         {
+         if (strcmp(pos, "NaN") || strcmp(neg, "NaN")) bad++;
+         continue;
+         }
+      if (neg[0] != '-' || strcmp(neg + 1, pos) ||
+          fltBits(strtof(pos, 0)) != bits)
+         {
+         if (bad++ < 10) printf("  %08X %s %s\n", bits, pos, neg);
+         continue;
+         }
+      if (bits == 0 || bits == 0x7F800000) continue;
+      n = splitDec(pos, &digits, &exp10);
+      if (n > 1 && (readsBack(digits / 10, exp10 + 1, bits) ||
+                    readsBack(digits / 10 + 1, exp10 + 1, bits) ||
+                    (digits / 10 > 1 && readsBack(digits / 10 - 1, exp10 + 1, bits))))
+         {
+         if (bad++ < 10) printf("  %08X %s not shortest\n", bits, pos);
+         }
+      if ((bits & 0x0FFFFFFF) == 0)
+         {
+         fprintf(stderr, "%08X\r", bits);
+         }
+      }
+   printf("checked %llu patterns, %llu bad\n", (unsigned long long)done,
+          (unsigned long long)bad);
+   return bad != 0;
+   } // End check()
+
+
+static uint32_t naiveFlt(uint32_t bits, char *buff)
+   {
+   float f = bitsFlt(bits);
+   int p;
+
+   for (p = 0; p < 9; p++)
+      {
+      snprintf(buff, 32, "%.*e", p, f);
+      if (fltBits(strtof(buff, 0)) == bits) break;
+      }
+   return strlen(buff);
+   } // End naiveFlt()
+
+
+static int bench(uint32_t count)
+   {
+   uint32_t *vals, i;
+   uint64_t sum;
+   char text[32];
+   double t0, fast, naive;
+
+   vals = malloc(count * sizeof(uint32_t));
+   for (i = 0; i < count; i++) vals[i] = randomFinite();
+
+   sum = 0;
+   t0  = nowSecs();
+   for (i = 0; i < count; i++) sum += fmtFlt(vals[i], text);
+   fast = nowSecs() - t0;
+   printf("fmtFlt  %8.1f ns/value  (%llu chars)\n", fast * 1e9 / count,
+          (unsigned long long)sum);
+
+   sum = 0;
+   t0  = nowSecs();
+   for (i = 0; i < count; i++) sum += naiveFlt(vals[i], text);
+   naive = nowSecs() - t0;
+   printf("naive   %8.1f ns/value  (%llu chars)\n", naive * 1e9 / count,
+          (unsigned long long)sum);
+   printf("speedup %.1fx\n", naive / fast);
+   free(vals);
+   return 0;
+   } // End bench()
+
+
+/*---------------------------------------------------------------------------
+  One differential case, strtof() must accept exactly what IeeeParse() does
+  and give the same bits, any NaN matching any NaN.
+---------------------------------------------------------------------------*/
+static uint32_t parseDiffers(const char *text)
+   {
+   IEEE_FLT bits = 0;
+   uint32_t ok, want;
+   char *end;
+
+   ok   = IeeeParse(text, strlen(text), &bits);
+   want = fltBits(strtof(text, &end));
+   if (ok != (*end == 0 && end != text)) return 1;
+   if (!ok || bits == want) return 0;
+   return (bits & 0x7FFFFFFF) <= 0x7F800000 || (want & 0x7FFFFFFF) <= 0x7F800000;
+   } // End parseDiffers()
+
+
+static int parse(uint32_t count)
+   {
+   static const char *fixed[] = { "13.125", "-1e-7", "0", "-0", ".5", "5.", "1E+2",
+      "3.4028235e38", "3.40282357e38", "1e-45", "7.006492321624085e-46", "1e39",
+      "1.000000059604644775390625", "1e-100000000", "000000000000000000000000000001",
+      "inf", "-Inf", "NaN", "", "-", ".", "1e", "1e+", "e5", "1.2.3", "1x", 0 };
+   char text[160];
+   uint32_t bits, i, bad = 0, done = 0;
+   double half;
+
+   for (i = 0; fixed[i]; i++, done++)
+      if (parseDiffers(fixed[i]) && bad++ < 10) printf("  '%s'\n", fixed[i]);
+   for (i = 0; i < count; i++, done++)
+      {
+      bits = randomFinite();
+      if (i & 1)
+         {
+         snprintf(text, sizeof(text), "%.*e", (int)(xorshift() % 12), bitsFlt(bits));
+         }
+      else
+         {
+         if ((bits & 0x7FFFFFFF) == 0x7F7FFFFF) bits--;
+         half = ((double)bitsFlt(bits) + bitsFlt(bits + 1)) / 2;   // exact
+         snprintf(text, sizeof(text), "%.*e", (int)(xorshift() % 140), half);
+         }
+      if (parseDiffers(text) && bad++ < 10) printf("  '%s'\n", text);
+      }
+   printf("parsed %u strings, %u differ from strtof\n", done, bad);
+   return bad != 0;
+   } // End parse()
+
+
+static int pbench(uint32_t count)
+   {
+   char *texts;
+   uint32_t *lens, i;
+   uint64_t sum;
+   IEEE_FLT bits;
+   double t0, fast, host;
+
+   texts = malloc((size_t)count * FMT_FLT_LEN);
+   lens  = malloc(count * sizeof(uint32_t));
+   for (i = 0; i < count; i++)
+      lens[i] = fmtFlt(randomFinite(), texts + (size_t)i * FMT_FLT_LEN);
+
+   sum = 0;
+   t0  = nowSecs();
+   for (i = 0; i < count; i++)
+      {
+      IeeeParse(texts + (size_t)i * FMT_FLT_LEN, lens[i], &bits);
+      sum += bits;
+      }
+   fast = nowSecs() - t0;
+   printf("IeeeParse %8.1f ns/value  (%llx)\n", fast * 1e9 / count,
+          (unsigned long long)sum);
+
+   sum = 0;
+   t0  = nowSecs();
+   for (i = 0; i < count; i++)
+      sum += fltBits(strtof(texts + (size_t)i * FMT_FLT_LEN, 0));
+   host = nowSecs() - t0;
+   printf("strtof    %8.1f ns/value  (%llx)\n", host * 1e9 / count,
+          (unsigned long long)sum);
+   printf("speedup %.1fx\n", host / fast);
+   free(texts);
+   free(lens);
+   return 0;
+   } // End pbench()
+
+
+/*---------------------------------------------------------------------------
+  The host's float arithmetic, the reference for arith and aall.  Encode
+  converts the 64 bit magnitude with one rounding and scales it by 2^-32,
+  which is exact for everything a 32.32 number can hold.
+---------------------------------------------------------------------------*/
+static uint32_t hostMult(uint32_t a, uint32_t b)
+   {
+   return fltBits(bitsFlt(a) * bitsFlt(b));
+   } // End hostMult()
+
+static uint32_t hostAdd(uint32_t a, uint32_t b)
+   {
+   return fltBits(bitsFlt(a) + bitsFlt(b));
+   } // End hostAdd()
+
+static uint32_t hostEncode(INT_FRACT x)
+   {
+   uint32_t neg = x.real >> 31;
+   uint32_t whole = neg ? 0u - x.real : x.real;
+   float f = (float)(((uint64_t)whole << 32) | x.fraction) * 0x1p-32f;
+
+   return fltBits(neg ? -f : f);
+   } // End hostEncode()
+
+
+/*---------------------------------------------------------------------------
+  Non zero if got is not want, any NaN matching any NaN.  The first few
+  mismatches of each check are printed.
+---------------------------------------------------------------------------*/
+static uint32_t fltDiffers(uint32_t got, uint32_t want)
+   {
+   if ((got & 0x7FFFFFFF) > 0x7F800000 && (want & 0x7FFFFFFF) > 0x7F800000) return 0;
+   return got != want;
+   } // End fltDiffers()
+
+static void tally(const char *op, uint32_t a, uint32_t b, uint32_t got, uint32_t want,
+                  uint64_t *bad)
+   {
+   if (!fltDiffers(got, want)) return;
+   if ((*bad)++ < MAX_SHOWN) printf("  %s %08X %08X gives %08X, host %08X\n", op, a, b, got, want);
+   } // End tally()
+
+
+/*---------------------------------------------------------------------------
+  Operands for arith.  A quarter are any bit pattern, the rest take an
+  exponent from the edges of the range or the middle and a fraction that
+  is random, all ones, zero or a single bit.
+---------------------------------------------------------------------------*/
+static uint32_t edgeFrac(void)
+   {
+   switch (xorshift() & 3)
+      {
+      case 0:  return 0x007FFFFF >> (xorshift() % 24);
+      case 1:  return (1u << (xorshift() % 23)) & 0x007FFFFF;
+      default: return xorshift() & 0x007FFFFF;
+      }
+   } // End edgeFrac()
+
+static uint32_t edgeExp(void)
+   {
+   static const uint32_t exps[] = { 0, 0, 1, 2, 23, 24, 25, 126, 127, 128, 253, 254, 254, 255 };
+
+   if (xorshift() & 1) return exps[xorshift() % (sizeof(exps) / sizeof(exps[0]))];
+   return xorshift() % 256;
+   } // End edgeExp()
+
+static uint32_t randomOperand(void)
+   {
+   if ((xorshift() & 3) == 0) return xorshift();
+   return (xorshift() & 0x80000000) | (edgeExp() << 23) | edgeFrac();
+   } // End randomOperand()
+
+// b near a, so a - b cancels and a + b carries
+static uint32_t nearOperand(uint32_t a)
+   {
+   uint32_t b = a + (xorshift() % 9) - 4;
+
+   if (xorshift() & 1) b = (b & ~0x007FFFFFu) | edgeFrac();
+   return b ^ (xorshift() & 0x80000000);
+   } // End nearOperand()
+
+// b whose exponent puts a * b just under the normal range or just over it
+static uint32_t scaleOperand(uint32_t a)
+   {
+   int32_t exp = (xorshift() & 1) ? 127 - 126 - (int32_t)(xorshift() % 26) : 127 + 128;
+
+   exp += (int32_t)(xorshift() % 5) - 2 - (int32_t)((a >> 23) & 0xFF) + 127;
+   if (exp < 0) exp = 0;
+   if (exp > 254) exp = 254;
+   return (xorshift() & 0x80000000) | ((uint32_t)exp << 23) | edgeFrac();
+   } // End scaleOperand()
+
+static INT_FRACT randomFixed(void)
+   {
+   INT_FRACT x;
+   uint32_t shift = xorshift() % 33;
+
+   x.real     = shift == 32 ? 0 : xorshift() >> shift;
+   x.fraction = (xorshift() & 1) ? xorshift() : xorshift() & (0xFFFFFFFFu << (xorshift() % 32));
+   if (xorshift() & 1) x.real = 0u - x.real;
+   return x;
+   } // End randomFixed()
+
+
+static int arith(uint32_t count)
+   {
+   uint32_t *a, *b, *z, i, kind;
+   INT_FRACT *x;
+   uint64_t bad = 0;
+
+   a = malloc(count * sizeof(uint32_t));
+   b = malloc(count * sizeof(uint32_t));
+   z = malloc(count * sizeof(uint32_t));
+   x = malloc(count * sizeof(INT_FRACT));
+
+   for (i = 0; i < count; i++)
+      {
+      a[i] = randomOperand();
+      kind = xorshift() % 3;
+      b[i] = kind == 0 ? randomOperand() : kind == 1 ? nearOperand(a[i]) : scaleOperand(a[i]);
+      tally("mul", a[i], b[i], IeeeMult(a[i], b[i]), hostMult(a[i], b[i]), &bad);
+      tally("add", a[i], b[i], IeeeAdd(a[i], b[i]), hostAdd(a[i], b[i]), &bad);
+      x[i] = randomFixed();
+      tally("enc", x[i].real, x[i].fraction, IeeeEncode(x[i]), hostEncode(x[i]), &bad);
+      }
+   IeeeMultV(a, b, z, count);
+   for (i = 0; i < count; i++) tally("mulv", a[i], b[i], z[i], IeeeMult(a[i], b[i]), &bad);
+   IeeeAddV(a, b, z, count);
+   for (i = 0; i < count; i++) tally("addv", a[i], b[i], z[i], IeeeAdd(a[i], b[i]), &bad);
+   IeeeEncodeV(x, z, count);
+   for (i = 0; i < count; i++) tally("encv", x[i].real, x[i].fraction, z[i], IeeeEncode(x[i]), &bad);
+
+   printf("checked %u each of mul, add and encode, scalar and batch, %llu bad\n", count,
+          (unsigned long long)bad);
+   free(a);
+   free(b);
+   free(z);
+   free(x);
+   return bad != 0;
+   } // End arith()
+
+
+static int arithAll(void)
+   {
+   static const uint32_t bs[] = { 0x3F800000, 0xBFC00000, 0x3F800001, 0x3EAAAAAB,
+                                  0x00000001, 0x80800000, 0x7F7FFFFF, 0x4B800001 };
+   static const uint32_t fracs[] = { 0, 0x80000000, 0x00000001, 0xFFFFFFFF };
+   static const uint32_t reals[] = { 0, 1, 0xFFFFFFFF, 0x01000001 };
+   uint64_t bad = 0, done = 0, v;
+   uint32_t i;
+   INT_FRACT x;
+
+   for (i = 0; i < sizeof(bs) / sizeof(bs[0]); i++)
+      {
+      for (v = 0; v < 0x100000000ull; v++)
+         {
+         tally("mul", (uint32_t)v, bs[i], IeeeMult((uint32_t)v, bs[i]), hostMult((uint32_t)v, bs[i]), &bad);
+         tally("add", (uint32_t)v, bs[i], IeeeAdd((uint32_t)v, bs[i]), hostAdd((uint32_t)v, bs[i]), &bad);
+         }
+      done += 2 * v;
+      fprintf(stderr, "b %08X done\r", bs[i]);
+      }
+   for (i = 0; i < 4; i++)
+      {
+      for (v = 0; v < 0x100000000ull; v++)
+         {
+         x.real = (uint32_t)v;
+         x.fraction = fracs[i];
+         tally("enc", x.real, x.fraction, IeeeEncode(x), hostEncode(x), &bad);
+         x.real = reals[i];
+         x.fraction = (uint32_t)v;
+         tally("enc", x.real, x.fraction, IeeeEncode(x), hostEncode(x), &bad);
+         }
+      done += 2 * v;
+      fprintf(stderr, "encode %u done  \r", i);
+      }
+   printf("checked %llu operations, %llu bad\n", (unsigned long long)done,
+          (unsigned long long)bad);
+   return bad != 0;
+   } // End arithAll()
+
+
+/*---------------------------------------------------------------------------
+  Timing for abench.  Operands are normal and their products and sums stay
+  normal, so the host's code is not timed on its slow subnormal path.
+  The host loops are whatever the compiler makes of them, vectorized or
+  not.
+---------------------------------------------------------------------------*/
+static void report(const char *name, uint32_t count, double secs, uint64_t ticks,
+                   const uint32_t *z)
+   {
+   uint32_t sum = 0, i;
+
+   for (i = 0; i < count; i++) sum += z[i];
+   printf("%-14s %6.2f ns/op", name, secs * 1e9 / count);
+#ifdef HAVE_TSC
+   printf("  %6.2f ticks/op", (double)ticks / count);
+#endif
+   printf("  (%08x)\n", sum);
+   } // End report()
+
+#define TIME_LOOP(name, body)                                           \
+   do {                                                                 \
+      double t0 = nowSecs();                                            \
+      uint64_t c0 = nowTicks();                                         \
+      body;                                                             \
+      report(name, count, nowSecs() - t0, nowTicks() - c0, z);          \
+      } while (0)
+
+static int abench(uint32_t count)
+   {
+   uint32_t *a, *b, *z, i;
+   INT_FRACT *x;
+
+   a = malloc(count * sizeof(uint32_t));
+   b = malloc(count * sizeof(uint32_t));
+   z = malloc(count * sizeof(uint32_t));
+   x = malloc(count * sizeof(INT_FRACT));
+   for (i = 0; i < count; i++)
+      {
+      a[i] = (xorshift() & 0x80000000) | ((64 + xorshift() % 128) << 23) | (xorshift() & 0x007FFFFF);
+      b[i] = (xorshift() & 0x80000000) | ((64 + xorshift() % 128) << 23) | (xorshift() & 0x007FFFFF);
+      x[i] = randomFixed();
+      }
+
+   TIME_LOOP("IeeeMult", for (i = 0; i < count; i++) z[i] = IeeeMult(a[i], b[i]));
+   TIME_LOOP("IeeeMultV", IeeeMultV(a, b, z, count));
+   TIME_LOOP("host mult", for (i = 0; i < count; i++) z[i] = hostMult(a[i], b[i]));
+   TIME_LOOP("IeeeAdd", for (i = 0; i < count; i++) z[i] = IeeeAdd(a[i], b[i]));
+   TIME_LOOP("IeeeAddV", IeeeAddV(a, b, z, count));
+   TIME_LOOP("host add", for (i = 0; i < count; i++) z[i] = hostAdd(a[i], b[i]));
+   TIME_LOOP("IeeeEncode", for (i = 0; i < count; i++) z[i] = IeeeEncode(x[i]));
+   TIME_LOOP("IeeeEncodeV", IeeeEncodeV(x, z, count));
+   TIME_LOOP("host encode", for (i = 0; i < count; i++) z[i] = hostEncode(x[i]));
+
+   free(a);
+   free(b);
+   free(z);
+   free(x);
+   return 0;
+   } // End abench()
+
+
+/*---------------------------------------------------------------------------
+  IeeeFma() against fmaf(), which glibc rounds once, on random operands
+  and on the cases a product rounded before the add gets wrong.  Each
+  kind is counted on its own so a failure shows where it is.
+    cancel   c is minus a * b rounded, give or take a few ulps, so all but
+             the product's low bits cancel
+    subnorm  a * b lands below 2^-126 and c is as small or zero
+    tie      a * b + c is exactly halfway between two floats: c is r and
+             a * b an odd multiple of half r's ulp, with r normal or
+             subnormal, either sign, and a * b of either sign
+    neartie  a * b + c a hair inside halfway, a * b being half r's ulp
+             times 1 - 2^-46, which rounded before the add is a tie
+    zero     a * b and c cancel exactly, and -0 * x + -0, for the sign of 0
+---------------------------------------------------------------------------*/
+#define FMA_KINDS 6
+
+static uint32_t fmaCancel(uint32_t *a, uint32_t *b)
+   {
+   *a = randomOperand();
+   *b = randomOperand();
+   return (hostMult(*a, *b) ^ 0x80000000) + (xorshift() % 9) - 4;
+   } // End fmaCancel()
+
+static uint32_t fmaSubnormal(uint32_t *a, uint32_t *b)
+   {
+   int32_t expA = 1 + xorshift() % 253, expB;
+
+   // biased exponents summing to 127 - 126 - 0..25 put a * b under 2^-126
+   expB = 1 - (int32_t)(xorshift() % 26) - expA + 127;
+   if (expB < 1) expB = 0;
+   *a = (xorshift() & 0x80000000) | ((uint32_t)expA << 23) | edgeFrac();
+   *b = (xorshift() & 0x80000000) | ((uint32_t)expB << 23) | edgeFrac();
+   if (xorshift() & 3) return (xorshift() & 0x80000000) | (xorshift() & 0x007FFFFF);
+   return xorshift() & 0x80000000;
+   } // End fmaSubnormal()
+
+static uint32_t fmaTie(uint32_t *a, uint32_t *b, uint32_t near)
+   {
+   uint32_t odd = (xorshift() % 1024) * 2 + 1;
+   int32_t  exp;
+   uint32_t c;
+
+   // r's ulp is 2^(exp - 150), a * b is odd * 2^(exp - 151).  A subnormal
+   // r has the ulp of exponent 1 and a takes the odd multiple's last halving.
+   // A near tie is (1 + 2^-23) * (1 - 2^-23) * 2^(exp - 151), split over a
+   // and b as biased exponents summing to exp + 102.
+   if (xorshift() & 3)
+      {
+      exp = 30 + xorshift() % 200;
+      c   = ((uint32_t)exp << 23) | (xorshift() & 0x007FFFFF);
+      *a  = fltBits((float)odd);
+      *b  = (uint32_t)(exp - 24) << 23;
+      }
+   else
+      {
+      exp = 1;
+      c   = xorshift() & 0x007FFFFF;
+      *a  = fltBits((float)odd * 0.5f);
+      *b  = 1;
+      }
+   if (near)
+      {
+      *a = ((uint32_t)(exp + 102) / 2 << 23) | 1;
+      *b = ((uint32_t)(exp + 102 - (exp + 102) / 2) << 23) | 0x007FFFFE;
+      }
+   *a ^= xorshift() & 0x80000000;
+   return c ^ (xorshift() & 0x80000000);
+   } // End fmaTie()
+
+static uint32_t fmaZero(uint32_t *a, uint32_t *b)
+   {
+   if (xorshift() & 1)
+      {
+      *a = 0x80000000;
+      *b = randomFinite() & 0x7FFFFFFF;
+      return xorshift() & 0x80000000;
+      }
+   // products of two 12 bit significands are exact, so c can be minus it
+   *a = (xorshift() & 0x80000000) | ((64 + xorshift() % 128) << 23) | (xorshift() & 0x007FF000);
+   *b = (xorshift() & 0x80000000) | ((64 + xorshift() % 128) << 23) | (xorshift() & 0x007FF000);
+   return hostMult(*a, *b) ^ 0x80000000;
+   } // End fmaZero()
+
+
+static int fmaCheck(uint32_t count)
+   {
+   static const char *names[FMA_KINDS] = { "random", "cancel", "subnorm", "tie", "neartie", "zero" };
+   uint64_t bad[FMA_KINDS] = { 0 }, total = 0;
+   uint32_t a, b, c, i, k;
+
+   for (i = 0; i < count; i++)
+      {
+      for (k = 0; k < FMA_KINDS; k++)
+         {
+         switch (k)
+            {
+            case 0:
+               a = randomOperand();
+               b = randomOperand();
+               c = randomOperand();
+               break;
+            case 1:  c = fmaCancel(&a, &b); break;
+            case 2:  c = fmaSubnormal(&a, &b); break;
+            case 3:  c = fmaTie(&a, &b, 0); break;
+            case 4:  c = fmaTie(&a, &b, 1); break;
+            default: c = fmaZero(&a, &b); break;
+            }
+         if (fltDiffers(IeeeFma(a, b, c), fltBits(fmaf(bitsFlt(a), bitsFlt(b), bitsFlt(c)))))
+            {
+            if (bad[k]++ < MAX_SHOWN)
+               printf("  %s %08X %08X %08X gives %08X, fmaf %08X\n", names[k], a, b, c,
+                      IeeeFma(a, b, c), fltBits(fmaf(bitsFlt(a), bitsFlt(b), bitsFlt(c))));
+            }
+         }
+      }
+   for (k = 0; k < FMA_KINDS; k++)
+      {
+      printf("%-8s %u, %llu bad\n", names[k], count, (unsigned long long)bad[k]);
+      total += bad[k];
+      }
+   return total != 0;
+   } // End fmaCheck()
+
+
+int main(int argc, char **argv)
+   {
+   uint32_t count = 1000000;
+
+   if (argc >= 4 && !strcmp(argv[2], "-n")) count = strtoul(argv[3], 0, 0);
+   if (argc >= 2 && !strcmp(argv[1], "check")) return check();
+   if (argc >= 2 && !strcmp(argv[1], "bench") && count) return bench(count);
+   if (argc >= 2 && !strcmp(argv[1], "parse")) return parse(count);
+   if (argc >= 2 && !strcmp(argv[1], "pbench") && count) return pbench(count);
+   if (argc >= 2 && !strcmp(argv[1], "arith")) return arith(count);
+   if (argc >= 2 && !strcmp(argv[1], "aall")) return arithAll();
+   if (argc >= 2 && !strcmp(argv[1], "abench") && count) return abench(count);
+   if (argc >= 2 && !strcmp(argv[1], "fma")) return fmaCheck(count);
+   fprintf(stderr, "usage: %s check | bench | parse | pbench [-n count]\n"
+           "       %s arith | aall | abench | fma [-n count]\n", argv[0], argv[0]);
+   return 1;
+   } // End main()
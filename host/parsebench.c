@@ -0,0 +1,387 @@
+//-------------------------------------------------------------------------
+// parsebench.c
+// Times the parser's inner kernels on the host.  parser.c is included
+// whole so its static helpers can be reached.
+//   lookup  findCmd()'s hashed index against the linear scan with the
+//           recursive strcmp it replaced, on tables of 6 and 200 command
+//           words.  The 200 word table is indexed with parser.c's own
+//           cmdHash() and cmdEqual(), the way buildCmdIndex() does it,
+//           and the live parseData[] is timed through findCmd() itself.
+//   hex     hexDecode() against the code it replaced, verifyHex()'s switch
+//           and char2Hex(), kept here as they were.  All 2^32 values as 8
+//           digits in mixed case, then every byte 0-255 at every place of
+//           tokens of 1 to 16 characters.  Valid or not must agree with
+//           the old code everywhere.  The old char2Hex() scaled the
+//           letters A-F wrongly and left aligned short tokens, so values
+//           are checked against a plain digit at a time decode, and
+//           against char2Hex() only for 8 decimal digits.
+//   hbench  the old three passes, verifyHex() twice and char2Hex(), against
+//           one hexDecode(), on valid and invalid 8 character tokens
+//
+//   cc -O2 -DHOST_SIM -I. -Ihost -o parsebench host/parsebench.c
+//      host/uartsim.c host/diskimg.c uart.c ring.c fmt.c timer.c trace.c
+//      ieee.c calc.c frame.c fat.c
+//   parsebench lookup [-n rounds]
+//   parsebench hex [-n count] | hbench [-n count]
+//
+// 10/18/2026 - Initial version
+// 10/18/2026 - hex and hbench
+//-------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../parser.c"
+
+#define BENCH_WORDS  200
+#define BENCH_MISSES 50                   // words that are no command
+
+
+static double nowNs(void)
+   {
+   struct timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return ts.tv_sec * 1e9 + ts.tv_nsec;
+   } // End nowNs()
+
+
+/*---------------------------------------------------------------------------
+  The lookup before the index, a scan of the table with the recursive
+  strcmp parser.c used to carry
+---------------------------------------------------------------------------*/
+static int oldStrcmp(const char *a, const char *b)
+   {
+   if (!(*a | *b)) return 0;
+   return (*a != *b) ? *a - *b : oldStrcmp(++a, ++b);
+   } // End oldStrcmp()
+
+static int oldFind(char **table, uint32_t n, const char *word)
+   {
+   uint32_t x;
+
+   for (x = 0; x < n; x++)
+      if (!oldStrcmp(word, table [x])) return x;
+   return -1;
+   } // End oldFind()
+
+
+/*---------------------------------------------------------------------------
+  The index of buildCmdIndex() and findCmd() over any table of words.
+  probes counts the buckets looked at, for the average chain.
+---------------------------------------------------------------------------*/
+static uint16_t benchIndex [CMD_HASH_SIZE];
+static uint64_t probes;
+
+static void benchBuild(char **table, uint32_t n)
+   {
+   uint32_t x, h;
+
+   memset(benchIndex, 0, sizeof(benchIndex));
+   for (x = 0; x < n; x++)
+      {
+      h = cmdHash(table [x], cmdLength(table [x]));
+      while (benchIndex [h] != 0) h = (h + 1) & (CMD_HASH_SIZE - 1);
+      benchIndex [h] = x + 1;
+      }
+   } // End benchBuild()
+
+static int benchFind(char **table, const char *word, uint32_t len)
+   {
+   uint32_t h = cmdHash(word, len);
+
+   while (benchIndex [h] != 0)
+      {
+      probes++;
+      if (cmdEqual(word, len, table [benchIndex [h] - 1])) return benchIndex [h] - 1;
+      h = (h + 1) & (CMD_HASH_SIZE - 1);
+      }
+   return -1;
+   } // End benchFind()
+
+
+/*---------------------------------------------------------------------------
+  n made up command words of 2 to 8 lower case letters, all different
+---------------------------------------------------------------------------*/
+static char **makeWords(uint32_t n, uint32_t seed)
+   {
+   char **words = calloc(n, sizeof(char *));
+   uint32_t i, j, k, len;
+
+   for (i = 0; i < n; i++)
+      {
+      words [i] = calloc(9, 1);
+      do
+         {
+         seed = seed * 1103515245 + 12345;
+         len = 2 + (seed >> 16) % 7;
+         for (k = 0; k < len; k++)
+            {
+            seed = seed * 1103515245 + 12345;
+            words [i] [k] = 'a' + (seed >> 16) % 26;
+            }
+         words [i] [len] = 0;
+         for (j = 0; j < i && strcmp(words [i], words [j]); j++) ;
+         }
+      while (j < i);
+      }
+   return words;
+   } // End makeWords()
+
+
+/*---------------------------------------------------------------------------
+  Looks up every word of the table and BENCH_MISSES others, rounds times
+  over, both ways, checking they agree
+---------------------------------------------------------------------------*/
+static int lookupTable(char **table, uint32_t n, uint32_t rounds)
+   {
+   char **misses = makeWords(BENCH_MISSES, 99);
+   uint32_t total = n + BENCH_MISSES, i, r, bad = 0;
+   char **words = calloc(total, sizeof(char *));
+   uint32_t *lens = calloc(total, sizeof(uint32_t));
+   volatile int sink = 0;
+   double t0, tOld, tNew;
+
+   for (i = 0; i < n; i++) words [i] = table [i];
+   for (i = 0; i < BENCH_MISSES; i++)
+      {
+      words [n + i] = misses [i];
+      if (oldFind(table, n, misses [i]) >= 0) words [n + i] = "zzzzzzzzz";
+      }
+   for (i = 0; i < total; i++) lens [i] = strlen(words [i]);
+
+   benchBuild(table, n);
+   for (i = 0; i < total; i++)
+      if (benchFind(table, words [i], lens [i]) != oldFind(table, n, words [i])) bad++;
+
+   t0 = nowNs();
+   for (r = 0; r < rounds; r++)
+      for (i = 0; i < total; i++) sink += oldFind(table, n, words [i]);
+   tOld = nowNs() - t0;
+   probes = 0;
+   t0 = nowNs();
+   for (r = 0; r < rounds; r++)
+      for (i = 0; i < total; i++) sink += benchFind(table, words [i], lens [i]);
+   tNew = nowNs() - t0;
+
+   printf("%3u commands  linear %7.1f ns  hashed %5.1f ns  %.2f probes/lookup  %u bad\n",
+          n, tOld / rounds / total, tNew / rounds / total,
+          (double)probes / rounds / total, bad);
+   for (i = 0; i < BENCH_MISSES; i++) free(misses [i]);
+   free(misses);
+   free(words);
+   free(lens);
+   return bad != 0;
+   } // End lookupTable()
+
+static int lookup(uint32_t rounds)
+   {
+   static char *six [] = { "type", "size", "hex", "fmul", "fadd", "fenc" };
+   char **big = makeWords(BENCH_WORDS, 1);
+   uint32_t i, r, bad = 0;
+   volatile uintptr_t sink = 0;
+   double t0;
+
+   bad += lookupTable(six, 6, rounds);
+   bad += lookupTable(big, BENCH_WORDS, rounds);
+
+   // The live table through findCmd() itself
+   for (i = 0; i < NUM_CMDS; i++)
+      if (findCmd(parseData [i].ParmCmdStr, cmdLength(parseData [i].ParmCmdStr)) != &parseData [i]) bad++;
+   t0 = nowNs();
+   for (r = 0; r < rounds; r++)
+      for (i = 0; i < NUM_CMDS; i++)
+         sink += (uintptr_t)findCmd(parseData [i].ParmCmdStr, cmdLength(parseData [i].ParmCmdStr));
+   printf("%3u commands  findCmd() on parseData[] %5.1f ns\n", (uint32_t)NUM_CMDS,
+          (nowNs() - t0) / rounds / NUM_CMDS);
+   return bad != 0;
+   } // End lookup()
+
+
+/*---------------------------------------------------------------------------
+  The hex path before hexDecode(), as it was
+---------------------------------------------------------------------------*/
+static uint32_t oldVerifyHex(const char *string)
+   {
+   uint32_t i = 0;
+
+   while (*string != '\0')
+      {
+      switch (*string)
+         {
+         case '0': case '1': case '2': case '3': case '4':
+         case '5': case '6': case '7': case '8': case '9':
+         case 'A': case 'a': case 'B': case 'b': case 'C': case 'c':
+         case 'D': case 'd': case 'E': case 'e': case 'F': case 'f':
+            i++;
+            break;
+         default:
+            return 0;
+         }
+      string++;
+      }
+   return i;
+   } // End oldVerifyHex()
+
+static uint32_t oldChar2Hex(const char *string)
+   {
+   uint32_t retval = 0x0;
+   int v [8] = { 0x10000000, 0x1000000, 0x100000, 0x10000, 0x1000, 0x100, 0x10, 0x1 };
+   int i = 0;
+   int n;
+
+   while (*string != 0x00)
+      {
+      n = *string;
+      if ((n - 0x30) >= 0 && (n - 0x30) <= 9)
+         retval += ((n - 0x30) * v [i]);
+      else if ((n - 0x41) >= 0 && (n - 0x41) <= 5)
+         {
+         retval = retval << 8;
+         retval += (v [i] * n);
+         }
+      else if ((n - 0x61) >= 0 && (n - 0x61) <= 5)
+         {
+         retval = retval << 8;
+         retval += (v [i] * n);
+         }
+      else
+         break;
+      i++;
+      ++string;
+      }
+   return retval;
+   } // End oldChar2Hex()
+
+// What parseCmdLine() said about a token before, rc 3 or not
+static uint32_t oldBadHex(const char *string)
+   {
+   return oldVerifyHex(string) == 0 || oldVerifyHex(string) % 2 != 0;
+   } // End oldBadHex()
+
+// A digit at a time, the last 8 digits of a valid token
+static uint32_t refHex(const char *string, uint32_t len)
+   {
+   uint32_t value = 0, c;
+
+   while (len--)
+      {
+      c = (uint8_t)*string++;
+      value = value << 4 | (c <= '9' ? c - '0' : (c | 0x20) - 'a' + 10);
+      }
+   return value;
+   } // End refHex()
+
+
+/*---------------------------------------------------------------------------
+  value as 8 hex digits, each letter upper or lower case by mix
+---------------------------------------------------------------------------*/
+static void hexText(uint32_t value, uint32_t mix, char *text)
+   {
+   static const char digits [] = "0123456789abcdef";
+   uint32_t i, d;
+
+   for (i = 0; i < 8; i++)
+      {
+      d = (value >> (28 - 4 * i)) & 15;
+      text [i] = digits [d] ^ ((d > 9 && (mix >> i & 1)) ? 0x20 : 0);
+      }
+   text [8] = 0;
+   } // End hexText()
+
+static uint32_t hexCheckOne(const char *text, uint32_t len, uint32_t *bad)
+   {
+   uint32_t rc, value, digits, i;
+
+   rc = hexDecode(text, len, &value);
+   if ((rc == HEX_BAD_DIGIT || rc == HEX_ODD_LEN) != oldBadHex(text)) (*bad)++;
+   if (rc == HEX_BAD_DIGIT) return rc;
+   if (value != refHex(text + (len > 8 ? len - 8 : 0), len > 8 ? 8 : len)) (*bad)++;
+   if (rc != (len & 1 ? HEX_ODD_LEN : len > 8 ? HEX_TOO_LONG : HEX_OK)) (*bad)++;
+   for (i = 0, digits = 1; i < len; i++) digits &= text [i] <= '9';
+   if (digits && len == 8 && value != oldChar2Hex(text)) (*bad)++;
+   return rc;
+   } // End hexCheckOne()
+
+static int hexCheck(uint64_t count)
+   {
+   char text [17];
+   uint32_t bad = 0, len, at, c, k, seed = 1;
+   uint64_t v, n = 0;
+
+   // Every 8 digit value, valid, letters in a mixed case
+   for (v = 0; v < count && v <= 0xFFFFFFFFu; v++)
+      {
+      hexText((uint32_t)v, (uint32_t)v * 2654435761u >> 24, text);
+      if (hexCheckOne(text, 8, &bad) != HEX_OK) bad++;
+      n++;
+      }
+
+   // Every byte at every place of every length, on random valid tokens
+   for (len = 1; len <= 16; len++)
+      for (at = 0; at < len; at++)
+         for (c = 1; c < 256; c++)
+            for (k = 0; k < 16; k++)
+               {
+               seed = seed * 1103515245 + 12345;
+               hexText(seed, seed >> 8, text);
+               seed = seed * 1103515245 + 12345;
+               hexText(seed, seed >> 8, text + 8);
+               text [len] = 0;
+               text [at]  = c;
+               hexCheckOne(text, len, &bad);
+               n++;
+               }
+   printf("%llu tokens checked, %u bad\n", (unsigned long long)n, bad);
+   return bad != 0;
+   } // End hexCheck()
+
+
+/*---------------------------------------------------------------------------
+  Times the old three passes against hexDecode(), on count tokens, a
+  quarter of them with one bad character
+---------------------------------------------------------------------------*/
+static int hexBench(uint32_t count)
+   {
+   enum { TOKENS = 4096 };
+   static char text [TOKENS] [9];
+   volatile uint32_t sink = 0;
+   uint32_t i, r, value, rounds = count / TOKENS + 1, seed = 7;
+   double t0, tOld, tNew;
+
+   for (i = 0; i < TOKENS; i++)
+      {
+      seed = seed * 1103515245 + 12345;
+      hexText(seed, seed >> 8, text [i]);
+      if (i % 4 == 3) text [i] [seed >> 29] = "gxZ \x80.-Q" [(seed >> 26) & 7];
+      }
+   t0 = nowNs();
+   for (r = 0; r < rounds; r++)
+      for (i = 0; i < TOKENS; i++)
+         if (!oldBadHex(text [i])) sink += oldChar2Hex(text [i]);
+   tOld = nowNs() - t0;
+   t0 = nowNs();
+   for (r = 0; r < rounds; r++)
+      for (i = 0; i < TOKENS; i++)
+         if (hexDecode(text [i], 8, &value) == HEX_OK) sink += value;
+   tNew = nowNs() - t0;
+   printf("8 character tokens  old three passes %5.1f ns  hexDecode() %5.1f ns\n",
+          tOld / rounds / TOKENS, tNew / rounds / TOKENS);
+   return 0;
+   } // End hexBench()
+
+
+int main(int argc, char **argv)
+   {
+   uint64_t count = 0;
+   int i;
+
+   for (i = 2; i < argc; i++)
+      if (!strcmp(argv [i], "-n") && i + 1 < argc) count = strtoull(argv [++i], 0, 0);
+   if (argc >= 2 && !strcmp(argv [1], "lookup")) return lookup(count ? count : 20000);
+   if (argc >= 2 && !strcmp(argv [1], "hex")) return hexCheck(count ? count : 1ull << 32);
+   if (argc >= 2 && !strcmp(argv [1], "hbench")) return hexBench(count ? count : 10000000);
+   fprintf(stderr, "usage: %s lookup [-n rounds]\n"
+           "       %s hex [-n count] | hbench [-n count]\n", argv [0], argv [0]);
+   return 1;
+   } // End main()
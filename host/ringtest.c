@@ -0,0 +1,195 @@
+//-------------------------------------------------------------------------
+// ringtest.c
+// Two thread stress test of the SPSC ring in ring.c.  A producer thread
+// pushes a counted byte sequence through ring_put(), ring_write() and
+// ring_write_span()/ring_commit(), picked at random with random lengths,
+// while a consumer thread drains it through ring_get() and
+// ring_read_span()/ring_consume().  Every byte is a hash of its position
+// in the sequence, so a byte lost, duplicated, reordered or read before
+// the producer's store is visible shows up as a mismatch within a byte or
+// two.  The count must come out exact and the ring empty at the end.
+// Ring sizes from 1 to 4096 bytes are run, the small ones keep both
+// indexes wrapping and the threads meeting at full and empty all the time.
+// Build it with -fsanitize=thread as well to have the ordering checked.
+//
+//   cc -O2 -pthread -I. -o ringtest host/ringtest.c ring.c
+//   ringtest [-n bytes per ring size]
+//
+// 10/18/2026 - Initial version
+//-------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <sched.h>
+#include <pthread.h>
+#include "ring.h"
+
+#define MAX_RING   4096
+#define MAX_CHUNK  64
+
+typedef struct
+   {
+   RING     ring;
+   uint64_t total;                        // bytes to push through
+   uint64_t received;
+   uint64_t bad;                          // bytes that did not match
+   uint64_t firstBad;                     // position of the first one
+   uint64_t overfull;                     // times count exceeded the size
+   } TEST;
+
+static uint8_t ringBuf [MAX_RING];
+
+
+/*---------------------------------------------------------------------------
+  Byte n of the sequence, and a small per thread random source
+---------------------------------------------------------------------------*/
+static uint8_t seqByte(uint64_t n)
+   {
+   return (uint8_t)((n * 0x9E3779B97F4A7C15ull) >> 56);
+   } // End seqByte()
+
+static uint32_t xorshift(uint32_t *state)
+   {
+   uint32_t x = *state;
+
+   x ^= x << 13;
+   x ^= x >> 17;
+   x ^= x << 5;
+   return *state = x;
+   } // End xorshift()
+
+
+/*---------------------------------------------------------------------------
+  Producer, one of the three ways of writing per turn.  Yields when the
+  ring is full so a single CPU box still makes progress.
+---------------------------------------------------------------------------*/
+static void *producer(void *arg)
+   {
+   TEST *t = arg;
+   uint8_t chunk [MAX_CHUNK];
+   uint8_t *span;
+   uint64_t sent = 0;
+   uint32_t rnd = 0x12345678, want, n, i;
+
+   while (sent < t->total)
+      {
+      want = xorshift(&rnd) % MAX_CHUNK + 1;
+      if (want > t->total - sent) want = (uint32_t)(t->total - sent);
+      switch (xorshift(&rnd) % 3)
+         {
+         case 0:
+            n = ring_put(&t->ring, seqByte(sent));
+            break;
+         case 1:
+            for (i = 0; i < want; i++) chunk [i] = seqByte(sent + i);
+            n = ring_write(&t->ring, chunk, want);
+            break;
+         default:
+            n = ring_write_span(&t->ring, &span);
+            if (n > want) n = want;
+            for (i = 0; i < n; i++) span [i] = seqByte(sent + i);
+            ring_commit(&t->ring, n);
+            break;
+         }
+      sent += n;
+      if (n == 0) sched_yield();
+      }
+   return 0;
+   } // End producer()
+
+
+/*---------------------------------------------------------------------------
+  Consumer, checks each byte against its place in the sequence
+---------------------------------------------------------------------------*/
+static void check(TEST *t, uint8_t byte)
+   {
+   if (byte != seqByte(t->received) && t->bad++ == 0) t->firstBad = t->received;
+   t->received++;
+   } // End check()
+
+static void *consumer(void *arg)
+   {
+   TEST *t = arg;
+   const uint8_t *span;
+   uint8_t byte;
+   uint32_t rnd = 0x9abcdef1, n, i;
+
+   while (t->received < t->total)
+      {
+      if (ring_count(&t->ring) > t->ring.mask + 1) t->overfull++;
+      if (xorshift(&rnd) & 1)
+         {
+         n = ring_get(&t->ring, &byte);
+         if (n) check(t, byte);
+         }
+      else
+         {
+         n = ring_read_span(&t->ring, &span);
+         if (n) n = xorshift(&rnd) % n + 1;
+         for (i = 0; i < n; i++) check(t, span [i]);
+         ring_consume(&t->ring, n);
+         }
+      if (n == 0) sched_yield();
+      }
+   return 0;
+   } // End consumer()
+
+
+/*---------------------------------------------------------------------------
+  One run over a ring of the given size, returns 1 if it failed
+---------------------------------------------------------------------------*/
+static int runSize(uint32_t size, uint64_t total)
+   {
+   TEST t;
+   pthread_t prod, cons;
+   struct timespec t0, t1;
+   double sec;
+   int fail;
+
+   memset(&t, 0, sizeof t);
+   memset(ringBuf, 0, sizeof ringBuf);
+   ring_init(&t.ring, ringBuf, size);
+   t.total = total;
+
+   clock_gettime(CLOCK_MONOTONIC, &t0);
+   if (pthread_create(&cons, 0, consumer, &t) || pthread_create(&prod, 0, producer, &t))
+      {
+      fprintf(stderr, "pthread_create failed\n");
+      exit(1);
+      }
+   pthread_join(prod, 0);
+   pthread_join(cons, 0);
+   clock_gettime(CLOCK_MONOTONIC, &t1);
+   sec = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9;
+
+   fail = t.bad || t.overfull || t.received != total || ring_count(&t.ring) != 0;
+   printf("ring %4u  %11llu bytes  %6.1f MB/s  bad %llu", size,
+          (unsigned long long)t.received, total / sec / 1e6, (unsigned long long)t.bad);
+   if (t.bad) printf(" (first at %llu)", (unsigned long long)t.firstBad);
+   if (t.overfull) printf("  overfull %llu", (unsigned long long)t.overfull);
+   if (ring_count(&t.ring)) printf("  %u left in ring", ring_count(&t.ring));
+   printf("  %s\n", fail ? "FAIL" : "ok");
+   return fail;
+   } // End runSize()
+
+
+int main(int argc, char **argv)
+   {
+   static const uint32_t sizes [] = { 1, 2, 16, 64, 256, 4096 };
+   uint64_t total = 4000000;
+   uint32_t i;
+   int fails = 0;
+
+   if (argc == 3 && !strcmp(argv [1], "-n")) total = strtoull(argv [2], 0, 0);
+   else if (argc != 1)
+      {
+      fprintf(stderr, "usage: %s [-n bytes per ring size]\n", argv [0]);
+      return 1;
+      }
+   for (i = 0; i < sizeof sizes / sizeof sizes [0]; i++) fails += runSize(sizes [i], total);
+   printf("%s\n", fails ? "FAILED" : "all sizes ok");
+   return fails != 0;
+   } // End main()
@@ -0,0 +1,185 @@
+//-------------------------------------------------------------------------
+// tracedec.c
+// Turns the text of a "trace dump" into Chrome trace event JSON, load the
+// result in chrome://tracing or ui.perfetto.dev.  Reads a terminal log on
+// stdin, everything outside the "trace N cycles/us" ... "trace end" block
+// is skipped.  Interrupts, commands and transmit stalls become slices on
+// their own rows, the rest are instant events.
+//
+//   cc -O2 -I. -o tracedec host/tracedec.c
+//   tracedec < putty.log > trace.json
+//
+// 10/18/2026 - Initial version
+//-------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "trace.h"
+
+#define ROW_MAIN   0
+#define ROW_IRQ    1
+#define ROW_TX     2
+
+typedef struct
+   {
+   uint64_t time;                         // unwrapped cycles
+   uint32_t seq;                          // dump order, breaks ties
+   uint16_t event;
+   uint16_t arg;
+   } EVENT;
+
+static EVENT   *events;
+static uint32_t nEvents;
+
+
+/*---------------------------------------------------------------------------
+  Time, then dump order.  Records claimed just before an interrupt can
+  carry a later stamp than the interrupt's own, sorting puts them right.
+---------------------------------------------------------------------------*/
+static int cmpEvent(const void *a, const void *b)
+   {
+   const EVENT *x = a, *y = b;
+
+   if (x->time != y->time) return x->time < y->time ? -1 : 1;
+   return x->seq < y->seq ? -1 : (x->seq > y->seq);
+   } // End cmpEvent()
+
+
+/*---------------------------------------------------------------------------
+  One JSON event, ts in microseconds
+---------------------------------------------------------------------------*/
+static void emit(const char *name, char ph, uint64_t time, double cyclesPerUs,
+                 int row, const char *args)
+   {
+   static int first = 1;
+
+   printf("%s\n  {\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":0,\"tid\":%d",
+          first ? "" : ",", name, ph, time / cyclesPerUs, row);
+   if (ph == 'i') printf(",\"s\":\"t\"");
+   if (args) printf(",\"args\":{%s}", args);
+   printf("}");
+   first = 0;
+   } // End emit()
+
+
+int main(void)
+   {
+   char     line [512], *p, *end;
+   char     args [64];
+   uint32_t count = 0, cyclesPerUs = 1, i, inDump = 0, cmdId = 0xFFFF;
+   uint32_t stamp, word, lastStamp = 0;
+   uint64_t time = 0;
+   EVENT   *ev;
+
+   while (fgets(line, sizeof(line), stdin))
+      {
+      if (!inDump)
+         {
+         if ((p = strstr(line, "trace ")) && sscanf(p, "trace %u %u", &count, &cyclesPerUs) == 2)
+            {
+            inDump  = 1;
+            nEvents = 0;
+            free(events);
+            events  = calloc(count ? count : 1, sizeof(EVENT));
+            }
+         continue;
+         }
+      if (strstr(line, "trace end")) break;
+
+      // 16 hex digits per record, stamp then event and arg
+      for (p = line; *p; p = end)
+         {
+         while (*p == ' ' || *p == '\r' || *p == '\n') p++;
+         if (strlen(p) < 16 || nEvents >= count) break;
+         char stampHex [9], wordHex [9];
+         memcpy(stampHex, p, 8);     stampHex [8] = 0;
+         memcpy(wordHex,  p + 8, 8); wordHex [8]  = 0;
+         stamp = strtoul(stampHex, 0, 16);
+         word  = strtoul(wordHex, 0, 16);
+         end   = p + 16;
+
+         // The cycle counter wraps, steps are taken as signed
+         time += (int32_t)(stamp - lastStamp);
+         if (nEvents == 0) time = stamp;
+         lastStamp = stamp;
+
+         ev = &events [nEvents];
+         ev->time  = time;
+         ev->seq   = nEvents++;
+         ev->event = word >> 16;
+         ev->arg   = word & 0xFFFF;
+         }
+      }
+   if (!inDump)
+      {
+      fprintf(stderr, "no trace dump found\n");
+      return 1;
+      }
+
+   qsort(events, nEvents, sizeof(EVENT), cmpEvent);
+   if (cyclesPerUs == 0) cyclesPerUs = 1;
+
+   printf("{\"traceEvents\":[");
+   for (i = 0; i < nEvents; i++)
+      {
+      ev = &events [i];
+      switch (ev->event)
+         {
+         case TR_IRQ_ENTER:
+            emit("irq", 'B', ev->time, cyclesPerUs, ROW_IRQ, 0);
+            break;
+         case TR_IRQ_EXIT:
+            snprintf(args, sizeof(args), "\"rx bytes\":%u", ev->arg);
+            emit("irq", 'E', ev->time, cyclesPerUs, ROW_IRQ, args);
+            break;
+         case TR_TX_DRAIN:
+            snprintf(args, sizeof(args), "\"bytes\":%u", ev->arg);
+            emit("tx drain", 'i', ev->time, cyclesPerUs, ROW_IRQ, args);
+            break;
+         case TR_RX_DROP:
+            snprintf(args, sizeof(args), "\"dropped\":%u", ev->arg);
+            emit("rx drop", 'i', ev->time, cyclesPerUs, ROW_IRQ, args);
+            break;
+         case TR_RX_THROTTLE:
+            emit("rx throttle", 'i', ev->time, cyclesPerUs, ROW_IRQ, 0);
+            break;
+         case TR_LINE:
+            snprintf(args, sizeof(args), "\"length\":%u", ev->arg);
+            emit("line", 'i', ev->time, cyclesPerUs, ROW_MAIN, args);
+            break;
+         case TR_QUEUE_FULL:
+            snprintf(args, sizeof(args), "\"depth\":%u", ev->arg);
+            emit("line queue full", 'i', ev->time, cyclesPerUs, ROW_MAIN, args);
+            break;
+         case TR_CMD_START:
+            cmdId = 0xFFFF;
+            snprintf(args, sizeof(args), "\"queued\":%u", ev->arg);
+            emit("command", 'B', ev->time, cyclesPerUs, ROW_MAIN, args);
+            break;
+         case TR_CMD_ID:
+            cmdId = ev->arg;
+            break;
+         case TR_CMD_END:
+            if (cmdId == 0xFFFF)
+               snprintf(args, sizeof(args), "\"rc\":%u", ev->arg);
+            else
+               snprintf(args, sizeof(args), "\"rc\":%u,\"parseData\":%u", ev->arg, cmdId);
+            emit("command", 'E', ev->time, cyclesPerUs, ROW_MAIN, args);
+            break;
+         case TR_TX_BLOCK:
+            emit("tx blocked", 'B', ev->time, cyclesPerUs, ROW_TX, 0);
+            break;
+         case TR_TX_UNBLOCK:
+            emit("tx blocked", 'E', ev->time, cyclesPerUs, ROW_TX, 0);
+            break;
+         default:
+            snprintf(args, sizeof(args), "\"event\":%u,\"arg\":%u", ev->event, ev->arg);
+            emit("unknown", 'i', ev->time, cyclesPerUs, ROW_MAIN, args);
+            break;
+         }
+      }
+   printf("\n]}\n");
+   return 0;
+   } // End main()
@@ -0,0 +1,225 @@
+//-------------------------------------------------------------------------
+// uartbench.c
+// End to end throughput of the command pipeline on the simulated mini UART:
+//   c_irq_handler -> rxbuffer -> echoPoll -> parseCmdLine -> callback
+//   -> uartPutC -> c_irq_handler -> wire
+// A scripted workload is sent at the given baud rate and every command is
+// timed from the arrival of its '\r' to the "\n\r" that ends its output.
+// With -m bin the same commands go as binary frames after "mode bin", see
+// frame.h, and are timed from the end of the request frame to the end of
+// the reply.  Only the float and chain workloads have a binary form.
+//
+//   cc -O2 -DHOST_SIM -I. -Ihost -o uartbench host/uartbench.c host/uartsim.c
+//      host/binproto.c host/diskimg.c uart.c parser.c ring.c fmt.c timer.c
+//      trace.c ieee.c calc.c frame.c fat.c
+//   uartbench [-b baud] [-n commands] [-m ascii|bin]
+//             [-w float|hex|errors|mixed|batch|decimal|chain|calc]
+//
+// 10/18/2026 - Initial version
+// 10/18/2026 - decimal workload
+// 10/18/2026 - chain and calc workloads, (a * b) + (c * d) both ways
+// 10/18/2026 - -m bin, the workload as binary frames
+//-------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "cmpe240.h"
+#include "uartsim.h"
+#include "frame.h"
+#include "binproto.h"
+
+extern void uart_init(void);
+extern void timer_init(void);
+extern void enable_irq(void);
+extern void echoPoll(void);
+extern volatile uint32_t rxDropped;
+extern uint32_t lineDepthMax;
+
+/*---------------------------------------------------------------------------
+  Workloads, each command produces exactly one line of output
+---------------------------------------------------------------------------*/
+static const char *floatCmds[] = { "fmul 41520000 41520000", "fadd 41520000 41520000",
+                                   "fenc FFFFFFF3 20000000", "fmul 3f800000 3f000000", 0 };
+static const char *hexCmds[]   = { "hex 313233", "hex 48656c6c6f2c20776f726c64", 0 };
+static const char *errorCmds[] = { "fmu 41520000", "fmul 4152", "hex 31q2", "fadd 41520000", 0 };
+static const char *mixedCmds[] = { "fmul 41520000 41520000", "hex 313233", "fadd 3f800000 3f000000",
+                                   "bogus", "fenc 0000000D 20000000", 0 };
+static const char *batchCmds[] = { "fmulv 41520000 41520000 3f800000 3f000000 40000000 40400000 c1520000 3f000000",
+                                   "faddv 41520000 41520000 3f800000 3f000000 40000000 40400000 c1520000 3f000000",
+                                   "fencv FFFFFFF3 20000000 0000000D 20000000 00000001 80000000 00800000 00000000", 0 };
+static const char *decimalCmds[] = { "fmul 13.125 13.125", "fadd 0.1 0.2", "fparse -1e-7",
+                                     "fmul 3.14159265358979323846 2", 0 };
+static const char *chainCmds[] = { "fmul 41520000 3f000000", "fmul 40400000 40000000",
+                                   "fadd 40D20000 40C00000", 0 };
+static const char *calcCmds[]  = { "calc (41520000 * 3f000000) + (40400000 * 40000000)", 0 };
+
+static struct
+   {
+   const char  *name;
+   const char **cmds;
+   } workloads[] = { { "float", floatCmds }, { "hex", hexCmds },
+                     { "errors", errorCmds }, { "mixed", mixedCmds },
+                     { "batch", batchCmds }, { "decimal", decimalCmds },
+                     { "chain", chainCmds }, { "calc", calcCmds }, };
+
+static uint64_t *started;               // arrival of each command's '\r'
+static uint64_t *latency;
+static uint32_t  nStarted, nDone;
+static uint64_t  rxBytes, txBytes, lastEvent;
+static uint8_t   prevTx;
+static uint32_t  binMode, binReady;     // -m bin, the "mode bin" frame came
+static FRAMERX   rxFrame, txFrame;
+
+
+static void onRx(uint8_t byte, uint64_t ns)
+   {
+   rxBytes++;
+   if (binMode)
+      {
+      if (frameRx(&rxFrame, byte) != FRAME_MORE) started[nStarted++] = ns;
+      }
+   else if (byte == '\r') started[nStarted++] = ns;
+   } // End onRx()
+
+static void onTx(uint8_t byte, uint64_t ns)
+   {
+   txBytes++;
+   lastEvent = ns;
+   if (binMode)
+      {
+      if (frameRx(&txFrame, byte) == FRAME_MORE) return;
+      if (txFrame.op == FRAME_OP_MODE)
+         binReady = 1;
+      else if (nDone < nStarted)
+         {
+         latency[nDone] = ns - started[nDone];
+         nDone++;
+         }
+      return;
+      }
+   if (prevTx == '\n' && byte == '\r' && nDone < nStarted)
+      {
+      latency[nDone] = ns - started[nDone];
+      nDone++;
+      }
+   prevTx = byte;
+   } // End onTx()
+
+static int cmpU64(const void *a, const void *b)
+   {
+   uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+   return (x > y) - (x < y);
+   } // End cmpU64()
+
+static double pct(uint32_t n, double p)
+   {
+   uint32_t i = (uint32_t)(p * (n - 1) + 0.5);
+   return latency[i] / 1000.0;
+   } // End pct()
+
+
+int main(int argc, char **argv)
+   {
+   uint32_t baud = 57600, count = 1000;
+   const char *wname = "mixed";
+   const char **cmds = 0;
+   uint64_t t0, t1;
+   double secs;
+   char line[128];
+   uint8_t frame[FRAME_MAX];
+   uint32_t i, n, len;
+
+   for (i = 1; i + 1 < (uint32_t)argc; i += 2)
+      {
+      if (!strcmp(argv[i], "-b")) baud  = strtoul(argv[i+1], 0, 0);
+      else if (!strcmp(argv[i], "-n")) count = strtoul(argv[i+1], 0, 0);
+      else if (!strcmp(argv[i], "-w")) wname = argv[i+1];
+      else if (!strcmp(argv[i], "-m")) binMode = !strcmp(argv[i+1], "bin");
+      }
+   for (i = 0; i < sizeof(workloads)/sizeof(workloads[0]); i++)
+      if (!strcmp(wname, workloads[i].name)) cmds = workloads[i].cmds;
+   if (!cmds || !count)
+      {
+      fprintf(stderr, "usage: %s [-b baud] [-n commands] [-m ascii|bin]\n"
+              "       [-w float|hex|errors|mixed|batch|decimal|chain|calc]\n", argv[0]);
+      return 1;
+      }
+   for (i = 0; binMode && cmds[i]; i++)
+      {
+      if (binFromText(cmds[i], frame) == 0)
+         {
+         fprintf(stderr, "\"%s\" has no binary frame\n", cmds[i]);
+         return 1;
+         }
+      }
+
+   started = calloc(count, sizeof(uint64_t));
+   latency = calloc(count, sizeof(uint64_t));
+
+   simOpen(baud);
+   simSetHooks(onRx, onTx);
+   timer_init();
+   uart_init();
+   enable_irq();
+
+   // Frames only go once the switch has been answered
+   if (binMode)
+      {
+      simFeed((const uint8_t *)"mode bin\r", 9);
+      t0 = simNow();
+      while (!binReady && simNow() - t0 < 5000000000ull)
+         {
+         simStep();
+         echoPoll();
+         }
+      if (!binReady)
+         {
+         fprintf(stderr, "no answer to mode bin\n");
+         return 1;
+         }
+      rxBytes = txBytes = 0;
+      }
+
+   for (i = n = 0; i < count; i++)
+      {
+      if (!cmds[n]) n = 0;
+      if (binMode)
+         {
+         len = binFromText(cmds[n++], frame);
+         simFeed(frame, len);
+         }
+      else
+         {
+         snprintf(line, sizeof(line), "%s\r", cmds[n++]);
+         simFeed((const uint8_t *)line, strlen(line));
+         }
+      }
+
+   t0 = lastEvent = simNow();
+   while (nDone < count)
+      {
+      simStep();
+      echoPoll();
+      if (simNow() - lastEvent > 5000000000ull && simNow() - t0 > 5000000000ull)
+         {
+         fprintf(stderr, "stalled after %u commands\n", nDone);
+         break;
+         }
+      }
+   t1 = simNow();
+
+   if (nDone == 0) return 1;
+   secs = (t1 - t0) / 1e9;
+   qsort(latency, nDone, sizeof(uint64_t), cmpU64);
+   printf("workload %s, %u baud, %s, %u commands in %.3f s\n", wname, baud,
+          binMode ? "binary frames" : "ascii", nDone, secs);
+   printf("  %.1f commands/s, rx %.0f bytes/s, tx %.0f bytes/s\n",
+          nDone / secs, rxBytes / secs, txBytes / secs);
+   printf("  %u FIFO overruns, %u bytes dropped from rxbuffer\n", simOverruns(), rxDropped);
+   printf("  line queue high-water %u\n", lineDepthMax);
+   printf("  latency us: p50 %.1f  p90 %.1f  p99 %.1f  max %.1f\n",
+          pct(nDone, 0.50), pct(nDone, 0.90), pct(nDone, 0.99), pct(nDone, 1.0));
+   return 0;
+   } // End main()
@@ -0,0 +1,261 @@
+//-------------------------------------------------------------------------
+// uartsim.c
+// Linux model of the BCM2835 mini UART behind REG_READ()/REG_WRITE().
+// Bytes handed to simFeed() arrive in the 8 byte receive FIFO at the
+// configured baud rate and the transmit FIFO drains at the same rate into
+// a capture hook.  Events are replayed in time order and c_irq_handler()
+// is called as soon as an enabled interrupt is pending, the same as the
+// ARM interrupt line would.  A baud rate of 0 models an infinitely fast
+// wire whose sender waits for room in the receive FIFO.
+// With receive auto flow control on (AUX_MU_CNTL_REG bit 2) the sender
+// also stops while RTS is de-asserted.
+// 10/18/2026 - Initial version
+// 10/18/2026 - Auto RTS flow control
+//-------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "cmpe240.h"
+#include "uartsim.h"
+
+#define SIM_FIFO  8
+
+extern void c_irq_handler(void);
+
+static struct
+   {
+   uint64_t nsPerByte;                  // 10 bit times, 0 = no wire delay
+   uint64_t rxDue;                      // next input byte's stop bit
+   uint64_t txDue;                      // current output byte's stop bit
+
+   uint8_t *in;                         // bytes still to be sent to us
+   uint32_t inLen, inPos, inSize;
+
+   uint8_t  rxFifo[SIM_FIFO];
+   uint32_t rxHead, rxCount;
+   uint8_t  txFifo[SIM_FIFO];
+   uint32_t txHead, txCount;
+
+   uint32_t ier;
+   uint32_t cntl;
+   uint32_t rtsLow;                     // sender is waiting for RTS
+   uint32_t overrun;                    // LSR bit 1, cleared on read
+   uint32_t overruns;                   // total bytes lost
+   uint32_t irqEnabled, inIrq;
+
+   SIM_HOOK rxHook, txHook;
+   } sim;
+
+
+/*---------------------------------------------------------------------------
+  Monotonic time in nanoseconds
+---------------------------------------------------------------------------*/
+uint64_t simNow(void)
+   {
+   struct timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return (uint64_t)ts.tv_sec*1000000000ull + ts.tv_nsec;
+   } // End simNow()
+
+
+/*---------------------------------------------------------------------------
+  Reset the model, baud is the line rate in bits per second
+---------------------------------------------------------------------------*/
+void simOpen(uint32_t baud)
+   {
+   free(sim.in);
+   memset(&sim, 0, sizeof(sim));
+   if (baud) sim.nsPerByte = 10000000000ull / baud;
+   } // End simOpen()
+
+
+void simSetHooks(SIM_HOOK rxHook, SIM_HOOK txHook)
+   {
+   sim.rxHook = rxHook;
+   sim.txHook = txHook;
+   } // End simSetHooks()
+
+
+uint32_t simOverruns(void)
+   {
+   return sim.overruns;
+   } // End simOverruns()
+
+
+/*---------------------------------------------------------------------------
+  Queue bytes for the remote end to send, they start arriving now
+---------------------------------------------------------------------------*/
+void simFeed(const uint8_t *bytes, uint32_t len)
+   {
+   uint64_t now = simNow();
+
+   if (sim.inPos == sim.inLen)
+      {
+      sim.inPos = sim.inLen = 0;
+      if (sim.rxDue < now) sim.rxDue = now + sim.nsPerByte;
+      }
+   if (sim.inLen + len > sim.inSize)
+      {
+      sim.inSize = (sim.inLen + len) * 2;
+      sim.in     = realloc(sim.in, sim.inSize);
+      }
+   memcpy(sim.in + sim.inLen, bytes, len);
+   sim.inLen += len;
+   } // End simFeed()
+
+
+/*---------------------------------------------------------------------------
+  Raise the interrupt line while an enabled interrupt is pending.
+  IER bit 0 enables receive, bit 1 transmit (see uart_init()).
+---------------------------------------------------------------------------*/
+static uint32_t simPending(void)
+   {
+   if ((sim.ier & 1) && sim.rxCount)      return 4;
+   if ((sim.ier & 2) && sim.txCount == 0) return 2;
+   return 0;
+   } // End simPending()
+
+static void simIrq(void)
+   {
+   if (!sim.irqEnabled || sim.inIrq) return;
+   sim.inIrq = 1;
+   while (simPending()) c_irq_handler();
+   sim.inIrq = 0;
+   } // End simIrq()
+
+
+/*---------------------------------------------------------------------------
+  RTS as driven by receive auto flow control, de-asserted once the receive
+  FIFO is down to 3, 2, 1 or 4 free places (AUX_MU_CNTL_REG bits 5:4)
+---------------------------------------------------------------------------*/
+static uint32_t simRts(void)
+   {
+   static const uint32_t spaces[4] = { 3, 2, 1, 4 };
+
+   if (!(sim.cntl & 0x04)) return 1;
+   return SIM_FIFO - sim.rxCount > spaces[(sim.cntl >> 4) & 3];
+   } // End simRts()
+
+
+/*---------------------------------------------------------------------------
+  Replay every wire event up to now in time order.  Each input byte whose
+  stop bit has passed lands in the receive FIFO (or is lost if it is full)
+  and each output byte whose stop bit has passed leaves the transmit FIFO.
+---------------------------------------------------------------------------*/
+void simStep(void)
+   {
+   uint64_t now = simNow();
+   uint32_t rxReady, txReady;
+   uint8_t  byte;
+
+   while (1)
+      {
+      // A sender held off by RTS starts its next byte once RTS is back
+      if (!simRts())
+         {
+         sim.rtsLow = 1;
+         }
+      else if (sim.rtsLow)
+         {
+         sim.rtsLow = 0;
+         if (sim.rxDue < now) sim.rxDue = now + sim.nsPerByte;
+         }
+
+      rxReady = sim.inPos < sim.inLen && sim.rxDue <= now && !sim.rtsLow &&
+                (sim.nsPerByte || sim.rxCount < SIM_FIFO);
+      txReady = sim.txCount && sim.txDue <= now;
+      if (!rxReady && !txReady) break;
+
+      if (rxReady && (!txReady || sim.rxDue <= sim.txDue))
+         {
+         byte = sim.in[sim.inPos++];
+         if (sim.rxCount < SIM_FIFO)
+            {
+            sim.rxFifo[(sim.rxHead + sim.rxCount++) % SIM_FIFO] = byte;
+            if (sim.rxHook) sim.rxHook(byte, sim.rxDue);
+            }
+         else
+            {
+            sim.overrun = 1;
+            sim.overruns++;
+            }
+         sim.rxDue += sim.nsPerByte;
+         }
+      else
+         {
+         byte = sim.txFifo[sim.txHead];
+         sim.txHead = (sim.txHead + 1) % SIM_FIFO;
+         sim.txCount--;
+         if (sim.txHook) sim.txHook(byte, sim.txDue);
+         if (sim.txCount) sim.txDue += sim.nsPerByte;
+         }
+      simIrq();
+      }  // End while
+   simIrq();
+   } // End simStep()
+
+
+/*---------------------------------------------------------------------------
+  Mini UART register reads, see uart_init() for the bit layouts
+---------------------------------------------------------------------------*/
+uint32_t simRead(uint32_t addr)
+   {
+   uint32_t value = 0;
+
+   switch (addr)
+      {
+      case AUX_MU_IO_REG:
+         if (sim.rxCount)
+            {
+            value = sim.rxFifo[sim.rxHead];
+            sim.rxHead = (sim.rxHead + 1) % SIM_FIFO;
+            sim.rxCount--;
+            }
+         break;
+      case AUX_MU_IIR_REG:
+         value = simPending();
+         value = 0xC0 | (value ? value : 1);
+         break;
+      case AUX_MU_LSR_REG:
+         value = (sim.rxCount ? 0x01 : 0) | (sim.overrun << 1) |
+                 (sim.txCount < SIM_FIFO ? 0x20 : 0) | (sim.txCount ? 0 : 0x40);
+         sim.overrun = 0;
+         break;
+      }
+   return value;
+   } // End simRead()
+
+
+/*---------------------------------------------------------------------------
+  Mini UART register writes, everything that is not modelled is ignored
+---------------------------------------------------------------------------*/
+void simWrite(uint32_t addr, uint32_t value)
+   {
+   switch (addr)
+      {
+      case AUX_MU_IO_REG:
+         if (sim.txCount == SIM_FIFO) break;
+         if (sim.txCount == 0) sim.txDue = simNow() + sim.nsPerByte;
+         sim.txFifo[(sim.txHead + sim.txCount++) % SIM_FIFO] = value;
+         break;
+      case AUX_MU_IER_REG:
+         sim.ier = value;
+         simIrq();
+         break;
+      case AUX_MU_CNTL_REG:
+         sim.cntl = value;
+         break;
+      }
+   } // End simWrite()
+
+
+/*---------------------------------------------------------------------------
+  Stand ins for the assembly routines of the firmware build
+---------------------------------------------------------------------------*/
+void enable_irq(void)
+   {
+   sim.irqEnabled = 1;
+   simIrq();
+   } // End enable_irq()
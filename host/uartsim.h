@@ -0,0 +1,24 @@
+//-------------------------------------------------------------------------
+// uartsim.h
+// Simulated BCM2835 mini UART for host builds (-DHOST_SIM)
+// 10/18/2026 - Initial version
+// 10/18/2026 - simStep() for drivers that run the simulation themselves
+//-------------------------------------------------------------------------
+
+#ifndef UARTSIM_H
+#define UARTSIM_H
+
+#include <stdint.h>
+
+// Called for every byte that finishes crossing the wire, ns is the
+// simulated time the last stop bit ended
+typedef void (*SIM_HOOK)(uint8_t byte, uint64_t ns);
+
+void     simOpen(uint32_t baud);
+void     simSetHooks(SIM_HOOK rxHook, SIM_HOOK txHook);
+void     simFeed(const uint8_t *bytes, uint32_t len);
+void     simStep(void);
+uint64_t simNow(void);
+uint32_t simOverruns(void);
+
+#endif // UARTSIM_H
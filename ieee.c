@@ -0,0 +1,788 @@
+//-------------------------------------------------------------------------
+// ieee.c
+// Single precision softfloat for IeeeMult(), IeeeAdd() and IeeeEncode(),
+// the entry points cmpe240.h declares.  Integer only, round to nearest
+// even, with subnormals, infinities and NaNs.  A NaN operand comes back
+// quieted, the first one if both are, an invalid operation (Inf * 0,
+// Inf - Inf) gives the default NaN.  Link this ahead of the library
+// versions.
+//
+// Internally a significand is a uint32_t with its leading one at bit 30
+// and 7 rounding bits below the 23 fraction bits.  Exponents are carried
+// as the biased exponent minus one so that adding the leading one while
+// packing brings it back, which also carries a rounding overflow or a
+// subnormal rounding up to normal into the exponent for free.
+// 10/18/2026 - Initial version
+// 10/18/2026 - Batch kernels, SSE on host builds
+// 10/18/2026 - IeeeFma(), a * b + c with one rounding
+// 10/18/2026 - IeeeParse(), correctly rounded decimal input
+//-------------------------------------------------------------------------
+
+#include <stdint.h>
+#include "cmpe240.h"
+#include "ieee.h"
+
+// The BCM2835's ARM1176 has VFP but no NEON, so the batch kernels use
+// the integer code there.  Host builds hand four lanes at a time to SSE,
+// which rounds the same way and keeps subnormals by default.
+#if defined(HOST_SIM) && defined(__SSE2__)
+#include <emmintrin.h>
+#define BATCH_SSE 1
+#endif
+
+#define SIGN_BIT        0x80000000u
+#define EXP_OF(x)       ((int32_t)(((x) >> 23) & 0xFF))
+#define FRAC_OF(x)      ((x) & 0x007FFFFFu)
+#define HIDDEN_BIT      0x00800000u
+#define QUIET_BIT       0x00400000u
+#define INF             0x7F800000u
+#define DEFAULT_NAN     0x7FC00000u
+#define IS_NAN(x)       (((x) & 0x7FFFFFFFu) > INF)
+
+
+/*---------------------------------------------------------------------------
+  x shifted right by count, any 1 bits shifted out are ORed into bit 0 so
+  rounding still sees them
+---------------------------------------------------------------------------*/
+static uint32_t shiftRightJam(uint32_t x, uint32_t count)
+   {
+   if (count == 0) return x;
+   if (count >= 31) return x != 0;
+   return (x >> count) | ((x << (32 - count)) != 0);
+   } // End shiftRightJam()
+
+
+/*---------------------------------------------------------------------------
+  The same for 64 bits
+---------------------------------------------------------------------------*/
+static uint64_t shiftRightJam64(uint64_t x, uint32_t count)
+   {
+   if (count == 0) return x;
+   if (count >= 63) return x != 0;
+   return (x >> count) | ((x << (64 - count)) != 0);
+   } // End shiftRightJam64()
+
+
+/*---------------------------------------------------------------------------
+  Rounds sig to nearest even and packs it.  exp is the biased exponent
+  minus one, below zero the result is subnormal and above 0xFD it
+  overflows to infinity.
+---------------------------------------------------------------------------*/
+static IEEE_FLT roundPack(uint32_t sign, int32_t exp, uint32_t sig)
+   {
+   uint32_t roundBits;
+
+   if ((uint32_t)exp >= 0xFD)
+      {
+      if (exp < 0)
+         {
+         sig = shiftRightJam(sig, -exp);
+         exp = 0;
+         }
+      else if (exp > 0xFD || sig + 0x40 >= 0x80000000u)
+         {
+         return sign | INF;
+         }
+      }
+   roundBits = sig & 0x7F;
+   sig = (sig + 0x40) >> 7;
+   if (roundBits == 0x40) sig &= ~1u;        // a tie goes to even
+   if (sig == 0) exp = 0;
+   return sign | (((uint32_t)exp << 23) + sig);
+   } // End roundPack()
+
+
+/*---------------------------------------------------------------------------
+  A NaN result for an operation with at least one NaN operand
+---------------------------------------------------------------------------*/
+static IEEE_FLT propagateNaN(IEEE_FLT a, IEEE_FLT b)
+   {
+   return (IS_NAN(a) ? a : b) | QUIET_BIT;
+   } // End propagateNaN()
+
+
+/*---------------------------------------------------------------------------
+  Multiply.  Subnormal operands are normalized with a clz first so the
+  product of the two 24 bit significands always has its leading one in
+  one of two places.
+---------------------------------------------------------------------------*/
+IEEE_FLT IeeeMult(IEEE_FLT a, IEEE_FLT b)
+   {
+   uint32_t sign = (a ^ b) & SIGN_BIT;
+   int32_t  expA = EXP_OF(a), expB = EXP_OF(b), expZ, shift;
+   uint32_t sigA = FRAC_OF(a), sigB = FRAC_OF(b), sigZ;
+   uint64_t product;
+
+   if (expA == 0xFF || expB == 0xFF)
+      {
+      if (IS_NAN(a) || IS_NAN(b)) return propagateNaN(a, b);
+      if (((a | b) & 0x7FFFFFFFu) == INF && ((a & 0x7FFFFFFFu) == 0 || (b & 0x7FFFFFFFu) == 0))
+         {
+         return DEFAULT_NAN;                  // Inf * 0
+         }
+      return sign | INF;
+      }
+
+   if (expA == 0)
+      {
+      if (sigA == 0) return sign;
+      shift = __builtin_clz(sigA) - 8;
+      sigA <<= shift;
+      expA = 1 - shift;
+      }
+   if (expB == 0)
+      {
+      if (sigB == 0) return sign;
+      shift = __builtin_clz(sigB) - 8;
+      sigB <<= shift;
+      expB = 1 - shift;
+      }
+
+   // Leading ones at 30 and 31 put the product's at 61 or 62
+   sigA = (sigA | HIDDEN_BIT) << 7;
+   sigB = (sigB | HIDDEN_BIT) << 8;
+   product = (uint64_t)sigA * sigB;
+   sigZ = (uint32_t)(product >> 32) | ((uint32_t)product != 0);
+   expZ = expA + expB - 0x7F;
+   if (sigZ < 0x40000000u)
+      {
+      expZ--;
+      sigZ <<= 1;
+      }
+   return roundPack(sign, expZ, sigZ);
+   } // End IeeeMult()
+
+
+/*---------------------------------------------------------------------------
+  Add, subtraction being an add of differing signs.  The larger magnitude
+  goes first so the result takes its sign, the smaller is aligned to it
+  with a sticky shift and one clz renormalizes whatever comes out.
+---------------------------------------------------------------------------*/
+IEEE_FLT IeeeAdd(IEEE_FLT a, IEEE_FLT b)
+   {
+   IEEE_FLT t;
+   uint32_t sign, sigA, sigB, sigZ, subtract;
+   int32_t  expA, expB, shift;
+
+   if (IS_NAN(a) || IS_NAN(b)) return propagateNaN(a, b);
+   if ((a & 0x7FFFFFFFu) < (b & 0x7FFFFFFFu))
+      {
+      t = a; a = b; b = t;
+      }
+   sign     = a & SIGN_BIT;
+   subtract = (a ^ b) & SIGN_BIT;
+   expA = EXP_OF(a);
+   expB = EXP_OF(b);
+
+   if (expA == 0xFF)
+      {
+      if (subtract && expB == 0xFF) return DEFAULT_NAN;    // Inf - Inf
+      return a;
+      }
+
+   // A subnormal has no hidden bit and the exponent of the smallest normal
+   sigA = FRAC_OF(a);
+   sigB = FRAC_OF(b);
+   if (expA != 0) sigA |= HIDDEN_BIT; else expA = 1;
+   if (expB != 0) sigB |= HIDDEN_BIT; else expB = 1;
+   sigA <<= 7;
+   sigB = shiftRightJam(sigB << 7, expA - expB);
+
+   sigZ = subtract ? sigA - sigB : sigA + sigB;
+   if (sigZ == 0)
+      {
+      return subtract ? 0 : sign;             // x - x is +0, -0 + -0 is -0
+      }
+
+   // Leading one back to bit 30, a carry into bit 31 shifts right once
+   shift = __builtin_clz(sigZ) - 1;
+   if (shift < 0)
+      {
+      sigZ = (sigZ >> 1) | (sigZ & 1);
+      }
+   else
+      {
+      sigZ <<= shift;
+      }
+   return roundPack(sign, expA - 1 - shift, sigZ);
+   } // End IeeeAdd()
+
+
+/*---------------------------------------------------------------------------
+  Converts a 32.32 fixed point number to single precision.  real holds the
+  integer part in two's complement, fraction the binary fraction, and the
+  sign of real applies to the whole number: {-13, 0.125} is -13.125.
+---------------------------------------------------------------------------*/
+IEEE_FLT IeeeEncode(INT_FRACT a)
+   {
+   uint32_t sign = a.real & SIGN_BIT;
+   uint32_t whole = sign ? 0u - a.real : a.real;
+   uint64_t fixed = ((uint64_t)whole << 32) | a.fraction;
+   uint32_t sig;
+   int32_t  top;
+
+   if (fixed == 0) return 0;
+
+   // Bit top is worth 2^(top - 32), bring it to bit 30
+   top = 63 - __builtin_clzll(fixed);
+   if (top >= 30)
+      {
+      sig = (uint32_t)(fixed >> (top - 30)) | ((fixed & ((1ull << (top - 30)) - 1)) != 0);
+      }
+   else
+      {
+      sig = (uint32_t)fixed << (30 - top);
+      }
+   return roundPack(sign, top - 32 + 0x7F - 1, sig);
+   } // End IeeeEncode()
+
+
+/*---------------------------------------------------------------------------
+  a * b + c rounded once.  The 48 bit product is kept exact in a 64 bit
+  significand with its leading one at bit 61 or 62, c is lined up at bit
+  62, whichever is smaller is shifted right with sticky bits, and the sum
+  is normalized with one clz before the single roundPack().  Cancellation
+  only happens when the two are within one exponent of each other, where
+  neither shift has lost anything.
+---------------------------------------------------------------------------*/
+IEEE_FLT IeeeFma(IEEE_FLT a, IEEE_FLT b, IEEE_FLT c)
+   {
+   uint32_t signP = (a ^ b) & SIGN_BIT, signC = c & SIGN_BIT, sign;
+   int32_t  expA = EXP_OF(a), expB = EXP_OF(b), expC = EXP_OF(c);
+   uint32_t sigA = FRAC_OF(a), sigB = FRAC_OF(b), sigC = FRAC_OF(c);
+   uint32_t zeroP, shift;
+   int32_t  expZ;
+   uint64_t sigP, sigC64, sigZ;
+
+   if (IS_NAN(a) || IS_NAN(b) || IS_NAN(c))
+      {
+      if (IS_NAN(a) || IS_NAN(b)) return propagateNaN(a, b);
+      return c | QUIET_BIT;
+      }
+   zeroP = (a & 0x7FFFFFFFu) == 0 || (b & 0x7FFFFFFFu) == 0;
+   if (expA == 0xFF || expB == 0xFF)
+      {
+      if (zeroP) return DEFAULT_NAN;                           // Inf * 0
+      if (expC == 0xFF && signC != signP) return DEFAULT_NAN;  // Inf - Inf
+      return signP | INF;
+      }
+   if (expC == 0xFF) return c;
+
+   // An exact zero product leaves c, -0 only if both zeros are negative
+   if (zeroP)
+      {
+      if ((c & 0x7FFFFFFFu) == 0) return signP & signC;
+      return c;
+      }
+
+   if (expA == 0)
+      {
+      shift = __builtin_clz(sigA) - 8;
+      sigA <<= shift;
+      expA = 1 - shift;
+      }
+   if (expB == 0)
+      {
+      shift = __builtin_clz(sigB) - 8;
+      sigB <<= shift;
+      expB = 1 - shift;
+      }
+   sigP = ((uint64_t)(sigA | HIDDEN_BIT) * (sigB | HIDDEN_BIT)) << 15;
+   expZ = expA + expB - 0x7E;
+   sign = signP;
+
+   if ((c & 0x7FFFFFFFu) != 0)
+      {
+      if (expC == 0)
+         {
+         shift = __builtin_clz(sigC) - 8;
+         sigC <<= shift;
+         expC = 1 - shift;
+         }
+      sigC64 = (uint64_t)(sigC | HIDDEN_BIT) << 39;
+
+      // Line the smaller up with the larger exponent
+      if (expZ >= expC)
+         {
+         sigC64 = shiftRightJam64(sigC64, expZ - expC);
+         }
+      else
+         {
+         sigP = shiftRightJam64(sigP, expC - expZ);
+         expZ = expC;
+         }
+
+      if (signP == signC)
+         {
+         sigP += sigC64;
+         }
+      else if (sigP >= sigC64)
+         {
+         sigP -= sigC64;
+         }
+      else
+         {
+         sigP = sigC64 - sigP;
+         sign = signC;
+         }
+      if (sigP == 0) return 0;                // exact cancellation is +0
+      }
+
+   // Leading one to bit 62, then keep the top 32 bits with sticky
+   shift = __builtin_clzll(sigP);
+   if (shift == 0)
+      {
+      sigP = (sigP >> 1) | (sigP & 1);
+      expZ++;
+      }
+   else
+      {
+      sigP <<= shift - 1;
+      expZ -= shift - 1;
+      }
+   sigZ = (sigP >> 32) | ((uint32_t)sigP != 0);
+   return roundPack(sign, expZ - 1, (uint32_t)sigZ);
+   } // End IeeeFma()
+
+
+#ifdef BATCH_SSE
+/*---------------------------------------------------------------------------
+  Makes SSE's NaN results match the integer code.  SSE returns whichever
+  NaN operand the compiler happened to put first, and its default NaN has
+  the sign bit set, so NaN lanes are rebuilt: a's NaN quieted if a has
+  one, else b's, and the default NaN when neither operand was a NaN.
+---------------------------------------------------------------------------*/
+static __m128i sseFixNaN(__m128 z, __m128 a, __m128 b)
+   {
+   __m128 nanA    = _mm_cmpunord_ps(a, a);
+   __m128 nanB    = _mm_cmpunord_ps(b, b);
+   __m128 nanZ    = _mm_cmpunord_ps(z, z);
+   __m128 operand = _mm_or_ps(nanA, nanB);
+   __m128 pick, invalid;
+
+   pick    = _mm_or_ps(_mm_and_ps(nanA, a), _mm_andnot_ps(nanA, b));
+   pick    = _mm_or_ps(pick, _mm_castsi128_ps(_mm_set1_epi32(QUIET_BIT)));
+   invalid = _mm_andnot_ps(operand, nanZ);
+
+   z = _mm_or_ps(_mm_andnot_ps(_mm_or_ps(operand, invalid), z), _mm_and_ps(operand, pick));
+   z = _mm_or_ps(z, _mm_and_ps(invalid, _mm_castsi128_ps(_mm_set1_epi32(DEFAULT_NAN))));
+   return _mm_castps_si128(z);
+   } // End sseFixNaN()
+
+#define SSE_LOAD(p)   _mm_castsi128_ps(_mm_loadu_si128((const __m128i *)(p)))
+#endif
+
+
+/*---------------------------------------------------------------------------
+  z[i] = a[i] * b[i] for n elements
+---------------------------------------------------------------------------*/
+void IeeeMultV(const IEEE_FLT *a, const IEEE_FLT *b, IEEE_FLT *z, uint32_t n)
+   {
+   uint32_t i = 0;
+
+#ifdef BATCH_SSE
+   for (; i + 4 <= n; i += 4)
+      {
+      __m128 va = SSE_LOAD(&a[i]);
+      __m128 vb = SSE_LOAD(&b[i]);
+
+      _mm_storeu_si128((__m128i *)&z[i], sseFixNaN(_mm_mul_ps(va, vb), va, vb));
+      }
+#endif
+   for (; i < n; i++)
+      {
+      z[i] = IeeeMult(a[i], b[i]);
+      }
+   } // End IeeeMultV()
+
+
+/*---------------------------------------------------------------------------
+  z[i] = a[i] + b[i] for n elements
+---------------------------------------------------------------------------*/
+void IeeeAddV(const IEEE_FLT *a, const IEEE_FLT *b, IEEE_FLT *z, uint32_t n)
+   {
+   uint32_t i = 0;
+
+#ifdef BATCH_SSE
+   for (; i + 4 <= n; i += 4)
+      {
+      __m128 va = SSE_LOAD(&a[i]);
+      __m128 vb = SSE_LOAD(&b[i]);
+
+      _mm_storeu_si128((__m128i *)&z[i], sseFixNaN(_mm_add_ps(va, vb), va, vb));
+      }
+#endif
+   for (; i < n; i++)
+      {
+      z[i] = IeeeAdd(a[i], b[i]);
+      }
+   } // End IeeeAddV()
+
+
+/*---------------------------------------------------------------------------
+  z[i] = IeeeEncode(a[i]) for n elements.  SSE2 has no exact conversion
+  for a 32.32 magnitude that can reach 2^63, so this one stays integer.
+---------------------------------------------------------------------------*/
+void IeeeEncodeV(const INT_FRACT *a, IEEE_FLT *z, uint32_t n)
+   {
+   uint32_t i;
+
+   for (i = 0; i < n; i++)
+      {
+      z[i] = IeeeEncode(a[i]);
+      }
+   } // End IeeeEncodeV()
+
+
+/*---------------------------------------------------------------------------
+  Decimal text to IEEE_FLT, see IeeeParse().  pow5Split [q + 65] is 5^q
+  scaled to [2^127, 2^128) and cut to 128 bits, rounded up below 5^0.  For
+  q outside POW5_MIN_Q..POW5_MAX_Q even 19 nines round to 0 or overflow.
+---------------------------------------------------------------------------*/
+#define POW5_MIN_Q      (-65)
+#define POW5_MAX_Q      38
+#define LEMIRE_MASK     (0xFFFFFFFFFFFFFFFFull >> 26)  // below the 24 + 2 bits kept
+#define PARSE_DIGITS    19                         // fit a uint64_t
+#define SLOW_DIGITS     120                        // more than any halfway point has
+#define BIG_LIMBS       32
+
+static const uint64_t pow5Split [POW5_MAX_Q - POW5_MIN_Q + 1][2] = {
+   { 0x86CCBB52EA94BAEAu, 0x98E947129FC2B4E9u }, { 0xA87FEA27A539E9A5u, 0x3F2398D747B36224u },
+   { 0xD29FE4B18E88640Eu, 0x8EEC7F0D19A03AADu }, { 0x83A3EEEEF9153E89u, 0x1953CF68300424ACu },
+   { 0xA48CEAAAB75A8E2Bu, 0x5FA8C3423C052DD7u }, { 0xCDB02555653131B6u, 0x3792F412CB06794Du },
+   { 0x808E17555F3EBF11u, 0xE2BBD88BBEE40BD0u }, { 0xA0B19D2AB70E6ED6u, 0x5B6ACEAEAE9D0EC4u },
+   { 0xC8DE047564D20A8Bu, 0xF245825A5A445275u }, { 0xFB158592BE068D2Eu, 0xEED6E2F0F0D56712u },
+   { 0x9CED737BB6C4183Du, 0x55464DD69685606Bu }, { 0xC428D05AA4751E4Cu, 0xAA97E14C3C26B886u },
+   { 0xF53304714D9265DFu, 0xD53DD99F4B3066A8u }, { 0x993FE2C6D07B7FABu, 0xE546A8038EFE4029u },
+   { 0xBF8FDB78849A5F96u, 0xDE98520472BDD033u }, { 0xEF73D256A5C0F77Cu, 0x963E66858F6D4440u },
+   { 0x95A8637627989AADu, 0xDDE7001379A44AA8u }, { 0xBB127C53B17EC159u, 0x5560C018580D5D52u },
+   { 0xE9D71B689DDE71AFu, 0xAAB8F01E6E10B4A6u }, { 0x9226712162AB070Du, 0xCAB3961304CA70E8u },
+   { 0xB6B00D69BB55C8D1u, 0x3D607B97C5FD0D22u }, { 0xE45C10C42A2B3B05u, 0x8CB89A7DB77C506Au },
+   { 0x8EB98A7A9A5B04E3u, 0x77F3608E92ADB242u }, { 0xB267ED1940F1C61Cu, 0x55F038B237591ED3u },
+   { 0xDF01E85F912E37A3u, 0x6B6C46DEC52F6688u }, { 0x8B61313BBABCE2C6u, 0x2323AC4B3B3DA015u },
+   { 0xAE397D8AA96C1B77u, 0xABEC975E0A0D081Au }, { 0xD9C7DCED53C72255u, 0x96E7BD358C904A21u },
+   { 0x881CEA14545C7575u, 0x7E50D64177DA2E54u }, { 0xAA242499697392D2u, 0xDDE50BD1D5D0B9E9u },
+   { 0xD4AD2DBFC3D07787u, 0x955E4EC64B44E864u }, { 0x84EC3C97DA624AB4u, 0xBD5AF13BEF0B113Eu },
+   { 0xA6274BBDD0FADD61u, 0xECB1AD8AEACDD58Eu }, { 0xCFB11EAD453994BAu, 0x67DE18EDA5814AF2u },
+   { 0x81CEB32C4B43FCF4u, 0x80EACF948770CED7u }, { 0xA2425FF75E14FC31u, 0xA1258379A94D028Du },
+   { 0xCAD2F7F5359A3B3Eu, 0x096EE45813A04330u }, { 0xFD87B5F28300CA0Du, 0x8BCA9D6E188853FCu },
+   { 0x9E74D1B791E07E48u, 0x775EA264CF55347Eu }, { 0xC612062576589DDAu, 0x95364AFE032A819Eu },
+   { 0xF79687AED3EEC551u, 0x3A83DDBD83F52205u }, { 0x9ABE14CD44753B52u, 0xC4926A9672793543u },
+   { 0xC16D9A0095928A27u, 0x75B7053C0F178294u }, { 0xF1C90080BAF72CB1u, 0x5324C68B12DD6339u },
+   { 0x971DA05074DA7BEEu, 0xD3F6FC16EBCA5E04u }, { 0xBCE5086492111AEAu, 0x88F4BB1CA6BCF585u },
+   { 0xEC1E4A7DB69561A5u, 0x2B31E9E3D06C32E6u }, { 0x9392EE8E921D5D07u, 0x3AFF322E62439FD0u },
+   { 0xB877AA3236A4B449u, 0x09BEFEB9FAD487C3u }, { 0xE69594BEC44DE15Bu, 0x4C2EBE687989A9B4u },
+   { 0x901D7CF73AB0ACD9u, 0x0F9D37014BF60A11u }, { 0xB424DC35095CD80Fu, 0x538484C19EF38C95u },
+   { 0xE12E13424BB40E13u, 0x2865A5F206B06FBAu }, { 0x8CBCCC096F5088CBu, 0xF93F87B7442E45D4u },
+   { 0xAFEBFF0BCB24AAFEu, 0xF78F69A51539D749u }, { 0xDBE6FECEBDEDD5BEu, 0xB573440E5A884D1Cu },
+   { 0x89705F4136B4A597u, 0x31680A88F8953031u }, { 0xABCC77118461CEFCu, 0xFDC20D2B36BA7C3Eu },
+   { 0xD6BF94D5E57A42BCu, 0x3D32907604691B4Du }, { 0x8637BD05AF6C69B5u, 0xA63F9A49C2C1B110u },
+   { 0xA7C5AC471B478423u, 0x0FCF80DC33721D54u }, { 0xD1B71758E219652Bu, 0xD3C36113404EA4A9u },
+   { 0x83126E978D4FDF3Bu, 0x645A1CAC083126EAu }, { 0xA3D70A3D70A3D70Au, 0x3D70A3D70A3D70A4u },
+   { 0xCCCCCCCCCCCCCCCCu, 0xCCCCCCCCCCCCCCCDu }, { 0x8000000000000000u, 0x0000000000000000u },
+   { 0xA000000000000000u, 0x0000000000000000u }, { 0xC800000000000000u, 0x0000000000000000u },
+   { 0xFA00000000000000u, 0x0000000000000000u }, { 0x9C40000000000000u, 0x0000000000000000u },
+   { 0xC350000000000000u, 0x0000000000000000u }, { 0xF424000000000000u, 0x0000000000000000u },
+   { 0x9896800000000000u, 0x0000000000000000u }, { 0xBEBC200000000000u, 0x0000000000000000u },
+   { 0xEE6B280000000000u, 0x0000000000000000u }, { 0x9502F90000000000u, 0x0000000000000000u },
+   { 0xBA43B74000000000u, 0x0000000000000000u }, { 0xE8D4A51000000000u, 0x0000000000000000u },
+   { 0x9184E72A00000000u, 0x0000000000000000u }, { 0xB5E620F480000000u, 0x0000000000000000u },
+   { 0xE35FA931A0000000u, 0x0000000000000000u }, { 0x8E1BC9BF04000000u, 0x0000000000000000u },
+   { 0xB1A2BC2EC5000000u, 0x0000000000000000u }, { 0xDE0B6B3A76400000u, 0x0000000000000000u },
+   { 0x8AC7230489E80000u, 0x0000000000000000u }, { 0xAD78EBC5AC620000u, 0x0000000000000000u },
+   { 0xD8D726B7177A8000u, 0x0000000000000000u }, { 0x878678326EAC9000u, 0x0000000000000000u },
+   { 0xA968163F0A57B400u, 0x0000000000000000u }, { 0xD3C21BCECCEDA100u, 0x0000000000000000u },
+   { 0x84595161401484A0u, 0x0000000000000000u }, { 0xA56FA5B99019A5C8u, 0x0000000000000000u },
+   { 0xCECB8F27F4200F3Au, 0x0000000000000000u }, { 0x813F3978F8940984u, 0x4000000000000000u },
+   { 0xA18F07D736B90BE5u, 0x5000000000000000u }, { 0xC9F2C9CD04674EDEu, 0xA400000000000000u },
+   { 0xFC6F7C4045812296u, 0x4D00000000000000u }, { 0x9DC5ADA82B70B59Du, 0xF020000000000000u },
+   { 0xC5371912364CE305u, 0x6C28000000000000u }, { 0xF684DF56C3E01BC6u, 0xC732000000000000u },
+   { 0x9A130B963A6C115Cu, 0x3C7F400000000000u }, { 0xC097CE7BC90715B3u, 0x4B9F100000000000u },
+   { 0xF0BDC21ABB48DB20u, 0x1E86D40000000000u }, { 0x96769950B50D88F4u, 0x1314448000000000u },
+ };
+
+typedef struct
+   {
+   uint32_t n;                             // limbs in use, no leading zeros
+   uint32_t limb [BIG_LIMBS];              // least significant first
+   } BIGNUM;
+
+
+/*---------------------------------------------------------------------------
+  The 128 bit product of a and b from four 32 x 32 multiplies
+---------------------------------------------------------------------------*/
+static void mul64(uint64_t a, uint64_t b, uint64_t *hi, uint64_t *lo)
+   {
+   uint64_t ll, lh, hl, hh, mid;
+
+   ll  = (uint64_t)(uint32_t)a * (uint32_t)b;
+   lh  = (uint64_t)(uint32_t)a * (b >> 32);
+   hl  = (a >> 32) * (uint32_t)b;
+   hh  = (a >> 32) * (b >> 32);
+   mid = (ll >> 32) + (uint32_t)lh + (uint32_t)hl;
+   *lo = (mid << 32) | (uint32_t)ll;
+   *hi = hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+   } // End mul64()
+
+
+/*---------------------------------------------------------------------------
+  Eisel-Lemire: w * 10^q rounded to nearest even, w != 0.  The normalized
+  w times the top 64 bits of 5^q, and the next 64 when the bits below the
+  25 kept could still carry, gives the significand, 2^q only moves the
+  exponent.  *sure is cleared when the truncated table entry leaves the
+  rounding undecided, the result is then off by at most one.
+---------------------------------------------------------------------------*/
+static uint32_t lemire(uint64_t w, int32_t q, uint32_t *sure)
+   {
+   uint64_t hi, lo, hi2, lo2, m;
+   int32_t  lz, upper, shift, exp;
+
+   *sure = 1;
+   if (w == 0 || q < POW5_MIN_Q) return 0;
+   if (q > POW5_MAX_Q) return INF;
+
+   lz = __builtin_clzll(w);
+   w <<= lz;
+   mul64(w, pow5Split [q - POW5_MIN_Q][0], &hi, &lo);
+   if ((hi & LEMIRE_MASK) == LEMIRE_MASK)
+      {
+      mul64(w, pow5Split [q - POW5_MIN_Q][1], &hi2, &lo2);
+      lo += hi2;
+      hi += lo < hi2;
+      }
+   if (lo == 0xFFFFFFFFFFFFFFFFull && q < -27)
+      *sure = 0;
+
+   upper = (int32_t)(hi >> 63);
+   shift = upper + 64 - 23 - 3;
+   m     = hi >> shift;                    // leading one at bit 24
+   exp   = ((217706 * q) >> 16) + 63 + upper - lz + 127;
+
+   if (exp <= 0)                           // subnormal, ties are impossible
+      {
+      if (1 - exp >= 64) return 0;
+      m >>= 1 - exp;
+      m += m & 1;
+      return (uint32_t)(m >> 1);           // 2^23 is the smallest normal
+      }
+   if (lo <= 1 && q >= -17 && q <= 10 && (m & 3) == 1 && (m << shift) == hi)
+      m &= ~1ull;                          // exactly halfway, round to even
+   m += m & 1;
+   m >>= 1;
+   if (m >= 2 * HIDDEN_BIT)
+      {
+      m = HIDDEN_BIT;
+      exp++;
+      }
+   if (exp >= 0xFF) return INF;
+   return ((uint32_t)exp << 23) | ((uint32_t)m & 0x007FFFFFu);
+   } // End lemire()
+
+
+/*---------------------------------------------------------------------------
+  b = b * mul + add, b << count and the sign of a - b on BIGNUMs.  The
+  numbers compared by slowParse() stay well below 32 limbs.
+---------------------------------------------------------------------------*/
+static void bigMulAdd(BIGNUM *b, uint32_t mul, uint32_t add)
+   {
+   uint64_t carry = add;
+   uint32_t i;
+
+   for (i = 0; i < b->n; i++)
+      {
+      carry += (uint64_t)b->limb [i] * mul;
+      b->limb [i] = (uint32_t)carry;
+      carry >>= 32;
+      }
+   if (carry) b->limb [b->n++] = (uint32_t)carry;
+   } // End bigMulAdd()
+
+static void bigShl(BIGNUM *b, uint32_t count)
+   {
+   uint32_t words = count >> 5, bits = count & 31, carry = 0, i;
+
+   if (bits)
+      {
+      for (i = 0; i < b->n; i++)
+         {
+         uint32_t v = b->limb [i];
+         b->limb [i] = (v << bits) | carry;
+         carry = v >> (32 - bits);
+         }
+      if (carry) b->limb [b->n++] = carry;
+      }
+   if (words && b->n)
+      {
+      for (i = b->n; i-- > 0; )
+         b->limb [i + words] = b->limb [i];
+      for (i = 0; i < words; i++)
+         b->limb [i] = 0;
+      b->n += words;
+      }
+   } // End bigShl()
+
+static int32_t bigCmp(const BIGNUM *a, const BIGNUM *b)
+   {
+   uint32_t i;
+
+   if (a->n != b->n) return a->n > b->n ? 1 : -1;
+   for (i = a->n; i-- > 0; )
+      if (a->limb [i] != b->limb [i]) return a->limb [i] > b->limb [i] ? 1 : -1;
+   return 0;
+   } // End bigCmp()
+
+static void bigPow5(BIGNUM *b, uint32_t e)
+   {
+   uint32_t mul;
+
+   for (; e >= 13; e -= 13)
+      bigMulAdd(b, 1220703125u, 0);        // 5^13
+   for (mul = 1; e > 0; e--)
+      mul *= 5;
+   bigMulAdd(b, mul, 0);
+   } // End bigPow5()
+
+
+/*---------------------------------------------------------------------------
+  Sign of dec * 10^e10 minus the point halfway between the finite bits and
+  the next float up, (2m + 1) * 2^(e2 - 1).
+---------------------------------------------------------------------------*/
+static int32_t cmpHalfway(const BIGNUM *dec, int32_t e10, uint32_t bits)
+   {
+   BIGNUM   l = *dec, r;
+   int32_t  exp = EXP_OF(bits), e2, l2, r2;
+   uint32_t m = FRAC_OF(bits);
+
+   if (exp == 0)
+      e2 = 1 - 150;
+   else
+      {
+      m |= HIDDEN_BIT;
+      e2 = exp - 150;
+      }
+   r.n = 1;
+   r.limb [0] = 2 * m + 1;
+   r2 = e2 - 1;
+   if (e10 >= 0)
+      bigPow5(&l, e10);                    // 10^e = 5^e * 2^e
+   else
+      bigPow5(&r, -e10);
+   l2 = e10;
+   if (l2 > r2)
+      bigShl(&l, l2 - r2);
+   else
+      bigShl(&r, r2 - l2);
+   return bigCmp(&l, &r);
+   } // End cmpHalfway()
+
+
+/*---------------------------------------------------------------------------
+  Exact rounding for digits the fast path could not settle.  The nSig
+  significant digits between digits and end, the last of them worth
+  10^e10, are read into a BIGNUM, past SLOW_DIGITS any non zero digit
+  just adds a 1.  bits, at most one off, is then moved to the float whose
+  halfway points bracket the value.
+---------------------------------------------------------------------------*/
+static uint32_t slowParse(const char *digits, const char *end, int32_t e10,
+                          uint32_t nSig, uint32_t bits)
+   {
+   BIGNUM   dec;
+   uint32_t kept = 0, sticky = 0;
+   int32_t  c;
+
+   dec.n = 0;
+   for (; digits < end; digits++)
+      {
+      if (*digits == '.' || (kept == 0 && *digits == '0')) continue;
+      if (kept < SLOW_DIGITS)
+         {
+         bigMulAdd(&dec, 10, *digits - '0');
+         kept++;
+         }
+      else
+         sticky |= *digits != '0';
+      }
+   e10 += nSig - kept;
+   if (sticky)
+      {
+      bigMulAdd(&dec, 10, 1);
+      e10--;
+      }
+
+   while (bits < INF)
+      {
+      c = cmpHalfway(&dec, e10, bits);
+      if (c < 0 || (c == 0 && (bits & 1) == 0)) break;
+      bits++;
+      }
+   while (bits > 0)
+      {
+      c = cmpHalfway(&dec, e10, bits - 1);
+      if (c > 0 || (c == 0 && (bits & 1) == 0)) break;
+      bits--;
+      }
+   return bits;
+   } // End slowParse()
+
+
+/*---------------------------------------------------------------------------
+  Converts the len characters at text, which need not be NUL terminated,
+  from decimal to the nearest IEEE single, ties to even.  Accepted are
+  [+-]digits[.digits][(e|E)[+-]digits] with at least one digit, and inf
+  and nan in any case.  Up to 19 significant digits are handled by
+  lemire() alone, longer inputs only go to slowParse() when w and w + 1
+  round differently.
+  Returns 1 and sets *res if text is a valid decimal, 0 if not.
+---------------------------------------------------------------------------*/
+uint32_t IeeeParse(const char *text, uint32_t len, IEEE_FLT *res)
+   {
+   const char *p = text, *end = text + len, *digits, *mEnd;
+   uint32_t sign = 0, nSig = 0, nFrac = 0, dot = 0, any = 0, sure, sure1;
+   uint32_t bits;
+   int32_t  exp10 = 0, expNeg = 0, e10, q;
+   uint64_t w = 0;
+
+   if (p < end && (*p == '+' || *p == '-'))
+      sign = (*p++ == '-') ? SIGN_BIT : 0;
+   if (end - p == 3)
+      {
+      uint32_t word = ((p [0] << 16) | (p [1] << 8) | p [2]) | 0x202020;
+      if (word == 0x696E66) { *res = sign | INF; return 1; }          // inf
+      if (word == 0x6E616E) { *res = sign | DEFAULT_NAN; return 1; }  // nan
+      }
+
+   digits = p;
+   for (; p < end; p++)
+      {
+      if (*p == '.' && !dot)
+         {
+         dot = 1;
+         continue;
+         }
+      if ((uint8_t)(*p - '0') > 9) break;
+      any = 1;
+      nFrac += dot;
+      if (nSig == 0 && *p == '0') continue;
+      if (nSig < PARSE_DIGITS) w = w * 10 + (*p - '0');
+      nSig++;
+      }
+   if (!any) return 0;
+   mEnd = p;
+   if (p < end && (*p == 'e' || *p == 'E'))
+      {
+      if (++p < end && (*p == '+' || *p == '-'))
+         expNeg = (*p++ == '-');
+      if (p == end) return 0;
+      for (; p < end && (uint8_t)(*p - '0') <= 9; p++)
+         if (exp10 < 100000) exp10 = exp10 * 10 + (*p - '0');
+      }
+   if (p != end) return 0;
+
+   e10  = (expNeg ? -exp10 : exp10) - (int32_t)nFrac;
+   q    = e10 + (int32_t)(nSig > PARSE_DIGITS ? nSig - PARSE_DIGITS : 0);
+   bits = lemire(w, q, &sure);
+   if (!sure || (nSig > PARSE_DIGITS && (lemire(w + 1, q, &sure1) != bits || !sure1)))
+      bits = slowParse(digits, mEnd, e10, nSig, bits);
+   *res = sign | bits;
+   return 1;
+   } // End IeeeParse()
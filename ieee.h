@@ -0,0 +1,25 @@
+//-------------------------------------------------------------------------
+// ieee.h
+// Fused multiply-add, decimal input and batch versions of the cmpe240.h
+// float entry points, see ieee.c.  Each batch result is bit for bit what
+// the scalar routine gives for that element.
+// 10/18/2026 - Initial version
+// 10/18/2026 - IeeeFma()
+// 10/18/2026 - IeeeParse()
+//-------------------------------------------------------------------------
+
+#ifndef IEEE_H
+#define IEEE_H
+
+#include <stdint.h>
+
+// IEEE_FLT and INT_FRACT come from cmpe240.h, include it first
+
+IEEE_FLT IeeeFma(IEEE_FLT a, IEEE_FLT b, IEEE_FLT c);
+uint32_t IeeeParse(const char *text, uint32_t len, IEEE_FLT *res);
+
+void IeeeMultV(const IEEE_FLT *a, const IEEE_FLT *b, IEEE_FLT *z, uint32_t n);
+void IeeeAddV(const IEEE_FLT *a, const IEEE_FLT *b, IEEE_FLT *z, uint32_t n);
+void IeeeEncodeV(const INT_FRACT *a, IEEE_FLT *z, uint32_t n);
+
+#endif // IEEE_H
@@ -6,16 +6,21 @@
 // 07/07/2013 - Initial version
 // 10/10/2013 - Fix head/tail
 // 09/09/2014 - remove rxbuffer[]
+// 10/18/2026 - Receive buffer is now a RING
+// 10/18/2026 - timer_init() and measured delays instead of dummy() loops
 //-------------------------------------------------------------------------
 
 #include <stdint.h>
 #include <cmpe240.h>
+#include "ring.h"
+#include "timer.h"
+
+// Pause between test lines
+#define TEST_DELAY_US 20
 /*---------------------------------------------------------------------------
   Interrupt handler variables 
 ---------------------------------------------------------------------------*/
-#define  RXBUFMASK 0xFFF
-extern volatile uint32_t rxhead;
-extern volatile uint32_t rxtail;
+extern RING rxRing;
 
 
 
@@ -31,7 +36,7 @@ void test_encode() {
 	INT_FRACT nums[] = { {0, 0}, {1, 0}, {0, 0x80000000}, {0, 0xC0000000}, {0xD, 0x20000000}, \
 	{0, 0xD5400000}, {0xfffffff3, 0x20000000}, {0x00800000, 0} };
 	IEEE_FLT flt = 0;
-	for (int temp = 0; temp < 1000; temp++) dummy();
+	delay_us(TEST_DELAY_US);
 
 	uartPutStr("Encoding:\n\0");
 	
@@ -41,7 +46,7 @@ void test_encode() {
 	
 	for(int i = 0; i < 8; i++) { 
 		flt = IeeeEncode(nums[i]);
-		for (int temp = 0; temp < 1000; temp++) dummy();
+		delay_us(TEST_DELAY_US);
 		uartHexStrings(nums[i].real);
 		uartHexStrings(nums[i].fraction);
 		uartHexStrings(flt);
@@ -56,7 +61,7 @@ void test_mul() {
 	INT_FRACT nums[] = { {0, 0}, {0x3f800000, 0x3f800000}, {0x3f000000, 0x3f000000}, {0x41520000, 0x41520000}, {0xC1520000, 0xC1520000}, \
 	{0x4B000000, 0x3f000000} }; //using int-fract struct for holding a and b
 	IEEE_FLT flt = 0;
-	for (int temp = 0; temp < 1000; temp++) dummy();
+	delay_us(TEST_DELAY_US);
 
 	uartPutStr("Multiply:\n\0");
 	uartPutC('\r');
@@ -65,7 +70,7 @@ void test_mul() {
 	
 	for(int i = 0; i < 6; i++) { 
 		flt = IeeeMult(nums[i].real, nums[i].fraction);
-		for (int temp = 0; temp < 1000; temp++) dummy();
+		delay_us(TEST_DELAY_US);
 		uartHexStrings(nums[i].real);
 		uartHexStrings(nums[i].fraction);
 		uartHexStrings(flt);
@@ -80,7 +85,7 @@ void test_add() {
 	INT_FRACT nums[] = { {0, 0}, {0x3f800000, 0x3f800000}, {0x3f000000, 0x3f000000}, {0x41520000, 0x41520000}, {0xC1520000, 0xC1520000}, \
 	{0x4B000000, 0x3f000000} }; //using int-fract struct for holding a and b
 	IEEE_FLT flt = 0;
-	for (int temp = 0; temp < 1000; temp++) dummy();
+	delay_us(TEST_DELAY_US);
 
 	uartPutStr("Add:\n\0");
 	uartPutC('\r');
@@ -89,7 +94,7 @@ void test_add() {
 	
 	for(int i = 0; i < 6; i++) { 
 		flt = IeeeAdd(nums[i].real, nums[i].fraction);
-		for (int temp = 0; temp < 1000; temp++) dummy();
+		delay_us(TEST_DELAY_US);
 		uartHexStrings(nums[i].real);
 		uartHexStrings(nums[i].fraction);
 		uartHexStrings(flt);
@@ -106,11 +111,14 @@ int main(void )
 {
 	
  
+    // Start the cycle counter and calibrate it
+    timer_init();
+
     // Initialize the UART with
     uart_init();
 	while(1) {
     // Zero out the circular buffer
-	rxtail = rxhead = 0;
+	ring_reset(&rxRing);
 
     // Enable interrupts
 	enable_irq();
@@ -0,0 +1,39 @@
+//-------------------------------------------------------------------------
+// mmio.h
+// Peripheral register access.  Firmware builds touch the BCM2835 registers
+// directly, host builds (-DHOST_SIM) route every access to a simulated
+// mini UART so the same uart.c and parser.c run on Linux.
+// 10/18/2026 - Initial version
+//-------------------------------------------------------------------------
+
+#ifndef MMIO_H
+#define MMIO_H
+
+#include <stdint.h>
+
+#ifdef HOST_SIM
+
+uint32_t simRead(uint32_t addr);
+void     simWrite(uint32_t addr, uint32_t value);
+void     simStep(void);
+
+#define REG_READ(addr)         simRead((uint32_t)(addr))
+#define REG_WRITE(addr, value) simWrite((uint32_t)(addr), (uint32_t)(value))
+
+// Spin loops give the simulator a chance to move bytes and raise interrupts
+#define REG_IDLE()             simStep()
+
+// c_irq_handler() is a plain function the simulator calls
+#define IRQ_HANDLER
+
+#else
+
+#define REG_READ(addr)         (*(volatile uint32_t *)(addr))
+#define REG_WRITE(addr, value) (*(volatile uint32_t *)(addr) = (value))
+#define REG_IDLE()
+
+#define IRQ_HANDLER            __attribute__((interrupt))
+
+#endif
+
+#endif // MMIO_H
@@ -2,32 +2,258 @@
   parser.c
   This implements a simple RPI command line parser
   12/12/2014 - Initial version
+  10/18/2026 - Hashed command lookup replaces the linear parseData[] scan
+  10/18/2026 - Zero copy tokenizer, commands read slices of the command line
+  10/18/2026 - Single pass hex validate and decode, 8 digits per step
+  10/18/2026 - Per command counters, phase times, latency histograms, stats
+  10/18/2026 - trace dump command
+  10/18/2026 - fmulv, faddv and fencv batch commands
+  10/18/2026 - ffma command
+  10/18/2026 - fdec command and fout, decimal results for the float commands
+  10/18/2026 - fparse command, decimal operands for the float commands
+  10/18/2026 - calc command
+  10/18/2026 - Memo cache for the pure commands, hex fmul fadd fenc ffma fdec
+  10/18/2026 - mode command and parseFrame(), binary frames for the pure commands
+  10/18/2026 - type and size on the FAT16 / FAT32 reader in fat.c
+  10/18/2026 - type seeks to the last 100 bytes, type -all, no readBuffer
+  10/18/2026 - Sector cache counters and sectors per disk command in stats
+  10/18/2026 - Directory index hits and builds in stats
+  10/18/2026 - type -all sends straight from a mapped disk
+  10/18/2026 - Command hash over the whole word
+  10/18/2026 - Too many parameters is a syntax error, not truncated
+  10/18/2026 - fmul, fadd and fenc examples match the decimal operand rule
+  10/18/2026 - Drop the unused HDDimage extern
+  10/18/2026 - Sector maps per disk command next to sectors/cmd
 --------------------------------------------------------------------------*/
 
 //#include "stdafx.h"
 //#include <afx.h>
 #include <cmpe240.h>
+#include "fmt.h"
+#include "timer.h"
+#include "trace.h"
+#include "ieee.h"
+#include "calc.h"
+#include "frame.h"
+#include "fat.h"
+
+/*---------------------------------------------------------------------------
+ A tokenized command line.  Each token is an (offset, length) slice of the
+ original line, nothing is copied.  tok[0] is the command word.
+---------------------------------------------------------------------------*/
+typedef struct
+{
+	uint16_t off;                        // offset of the token in line
+	uint16_t len;                        // number of characters
+} CMDSLICE;
+
+typedef struct
+{
+	const char *line;                    // the line the slices point into
+	uint32_t    count;                   // number of tokens found
+	uint32_t    more;                    // line had tokens past tok[]
+	CMDSLICE    tok[MAX_PARMS+1];
+	uint32_t    val[MAX_PARMS+1];        // decoded EvenHexOnly parameters
+} CMDTOKENS;
+
+#define TOKPTR(t, n) ((t)->line + (t)->tok[n].off)
+
+/*---------------------------------------------------------------------------
+ hexDecode() results, in the order they are checked
+---------------------------------------------------------------------------*/
+#define HEX_OK         0
+#define HEX_BAD_DIGIT  1                     // not 0-9, A-F or a-f
+#define HEX_ODD_LEN    2                     // not a whole number of bytes
+#define HEX_TOO_LONG   3                     // more than 8 digits
+
+uint32_t tokenizeCmdLine(const char *line, CMDTOKENS *tokens);
+uint32_t hexView(const CMDTOKENS *tokens);
+uint32_t hexPure(const uint32_t *val);
+void hexOut(uint32_t bytes);
+uint32_t fmulPure(const uint32_t *val);
+uint32_t faddPure(const uint32_t *val);
+uint32_t fencPure(const uint32_t *val);
+uint32_t statsView(const CMDTOKENS *tokens);
+uint32_t traceView(const CMDTOKENS *tokens);
+uint32_t fmulvView(const CMDTOKENS *tokens);
+uint32_t faddvView(const CMDTOKENS *tokens);
+uint32_t fencvView(const CMDTOKENS *tokens);
+uint32_t ffmaPure(const uint32_t *val);
+uint32_t fdecPure(const uint32_t *val);
+void fdecOut(uint32_t bits);
+uint32_t foutView(const CMDTOKENS *tokens);
+uint32_t fparseView(const CMDTOKENS *tokens);
+uint32_t calcView(const CMDTOKENS *tokens);
+uint32_t modeView(const CMDTOKENS *tokens);
+void uartWrite(const char *buf, uint32_t len);
+uint32_t uartWriteSome(const char *buf, uint32_t len);
+void uartFrameMode(uint32_t on);
+static void fltReply(IEEE_FLT res);
 
 /*---------------------------------------------------------------------------
  This global table contains the function parsing abstraction.  This maps
  each command line to a processing function and provides other key information
  about the parsing data.  See the structure definition for the full
- description.                  txt    callback  num       max    min evenHex
+ description.  A row's slot is also the command's op in binary frames, see
+ frame.h, so new rows only go at the end.
+                               txt    callback  num       max    min evenHex
 ---------------------------------------------------------------------------*/
-PARSEDATA parseData[6] = { { "type", &typeCall, 2, MAX_PARM_LEN, 1, 0, },
+PARSEDATA parseData[]  = { { "type", &typeCall, 2, MAX_PARM_LEN, 1, 0, },
                            { "size", &sizeCall, 2, MAX_PARM_LEN, 1, 0, },
-                           { "hex",  &hexCall,  2, MAX_PARM_LEN, 2, 1, },
-                           { "fmul", &fmulCall, 3,            8, 8, 1, },
-                           { "fadd", &faddCall, 3,            8, 8, 1, },
-                           { "fenc", &fencCall, 3,            8, 8, 1, }, };
+                           { "hex",  0,         2, MAX_PARM_LEN, 2, 1, },
+                           { "fmul", 0,         3,            8, 8, 1, },
+                           { "fadd", 0,         3,            8, 8, 1, },
+                           { "fenc", 0,         3,            8, 8, 1, },
+                           { "stats", 0,        1, MAX_PARM_LEN, 1, 0, },
+                           { "trace", 0,        2, MAX_PARM_LEN, 1, 0, },
+                           { "fmulv", 0,        3,            8, 8, 1, },
+                           { "faddv", 0,        3,            8, 8, 1, },
+                           { "fencv", 0,        3,            8, 8, 1, },
+                           { "ffma", 0,         4,            8, 8, 1, },
+                           { "fdec", 0,         2,            8, 8, 1, },
+                           { "fout", 0,         2, MAX_PARM_LEN, 1, 0, },
+                           { "fparse", 0,       2, MAX_PARM_LEN, 1, 0, },
+                           { "calc", 0,         2, CMD_LINE_LEN, 1, 0, },
+                           { "mode", 0,         2, MAX_PARM_LEN, 1, 0, }, };
+
+#define NUM_CMDS (sizeof(parseData)/sizeof(parseData[0]))
+
+
+/*---------------------------------------------------------------------------
+ Per command data that does not fit in PARSEDATA, in parseData[] order.
+ viewCall reads the token slices directly.  Commands without a viewCall
+ get their CMDPARM callBack through callParmAdapter().  NumParms is the
+ minimum for CMD_VARIADIC commands, every parameter present is validated.
+ CMD_DECIMAL_OK commands also take a decimal float for any parameter that
+ is not 8 hex digits, see floatOperand().  A line with more than MAX_PARMS
+ parameters is a syntax error, except for CMD_WHOLE_LINE commands which
+ read the rest of the line themselves.
+ The output of a CMD_PURE command depends on nothing but its decoded
+ parameters: pureCall computes a result from val[], which memoCall() may
+ supply from its cache instead, and outCall prints it.  viewCall is then
+ only used for a parameter too long to fit in val[].
+---------------------------------------------------------------------------*/
+#define CMD_VARIADIC    0x1
+#define CMD_DECIMAL_OK  0x2
+#define CMD_PURE        0x4
+#define CMD_WHOLE_LINE  0x8
+
+typedef struct
+{
+	uint32_t (*viewCall)(const CMDTOKENS *tokens);
+	uint32_t flags;
+	uint32_t (*pureCall)(const uint32_t *val);
+	void     (*outCall)(uint32_t result);
+} CMDEXT;
+
+CMDEXT cmdExt[] = { { 0,           0,                         0,         0,         },    // type
+                    { 0,           0,                         0,         0,         },    // size
+                    { &hexView,    CMD_PURE,                  &hexPure,  &hexOut,   },    // hex
+                    { 0,           CMD_PURE | CMD_DECIMAL_OK, &fmulPure, &fltReply, },    // fmul
+                    { 0,           CMD_PURE | CMD_DECIMAL_OK, &faddPure, &fltReply, },    // fadd
+                    { 0,           CMD_PURE,                  &fencPure, &fltReply, },    // fenc
+                    { &statsView,  0,                         0,         0,         },    // stats
+                    { &traceView,  0,                         0,         0,         },    // trace
+                    { &fmulvView,  CMD_VARIADIC | CMD_DECIMAL_OK, 0,     0,         },    // fmulv
+                    { &faddvView,  CMD_VARIADIC | CMD_DECIMAL_OK, 0,     0,         },    // faddv
+                    { &fencvView,  CMD_VARIADIC,              0,         0,         },    // fencv
+                    { 0,           CMD_PURE | CMD_DECIMAL_OK, &ffmaPure, &fltReply, },    // ffma
+                    { 0,           CMD_PURE,                  &fdecPure, &fdecOut,  },    // fdec
+                    { &foutView,   0,                         0,         0,         },    // fout
+                    { &fparseView, 0,                         0,         0,         },    // fparse
+                    { &calcView,   CMD_WHOLE_LINE,            0,         0,         },    // calc
+                    { &modeView,   0,                         0,         0,         }, }; // mode
+
+typedef char cmdExtCheck[(sizeof(cmdExt)/sizeof(cmdExt[0]) == NUM_CMDS) ? 1 : -1];
+typedef char frameOpCheck[(FRAME_OP_MODE == NUM_CMDS-1) ? 1 : -1];
+
+
+/*---------------------------------------------------------------------------
+ Command lookup index.  A command word hashes on its length and all of its
+ characters into cmdIndex[], which holds the parseData[] slot plus one, 0
+ marks an empty bucket.  Collisions probe linearly so a lookup is one hash
+ and normally one bounded compare, no matter how many commands there are.
+ The index is built from parseData[] the first time a command is looked up.
+---------------------------------------------------------------------------*/
+#define CMD_HASH_SIZE 512                  // power of 2, >= 2 * NUM_CMDS
+typedef char cmdHashCheck[(NUM_CMDS*2 <= CMD_HASH_SIZE) ? 1 : -1];
+static uint16_t cmdIndex[CMD_HASH_SIZE];
+static uint32_t cmdIndexBuilt;
+
+
+/*---------------------------------------------------------------------------
+ Per command statistics in parseData[] order, the extra last slot counts
+ lines that are not a command.  phase[] sums cycles spent tokenizing,
+ looking up and validating, in the command itself and, as part of that,
+ waiting for room in the transmit buffer.  lat[] is a log2 histogram of the
+ cycles from the line's CR arriving to its output being queued.  Costs four
+ cycle counter reads per line, so it stays on.
+---------------------------------------------------------------------------*/
+#define STAT_TOKENIZE  0
+#define STAT_VALIDATE  1
+#define STAT_CALL      2
+#define STAT_TXWAIT    3
+#define STAT_PHASES    4
+#define STAT_RCS       6                   // rc 1, 2, 3, 5, 10 and the rest
+#define STAT_BUCKETS   32
+
+typedef struct
+{
+	uint32_t count;
+	uint32_t errors[STAT_RCS];
+	uint64_t phase[STAT_PHASES];
+	uint32_t lat[STAT_BUCKETS];
+} CMDSTATS;
+
+static CMDSTATS cmdStats[NUM_CMDS+1];
+static CMDSTATS *statLast;                 // the line parsed last, 0 if blank
+
+
+
+/*---------------------------------------------------------------------------
+ Memo cache for CMD_PURE commands, direct mapped on the command and its
+ decoded parameters, so a repeated line skips the arithmetic.  MEMO_BITS
+ sets the size at compile time; -DMEMO_DISABLE leaves the cache out and
+ every line runs its pureCall, for testing.  Hits and misses show in stats.
+---------------------------------------------------------------------------*/
+#ifndef MEMO_BITS
+#define MEMO_BITS      6                   // 64 entries of 20 bytes
+#endif
+#define MEMO_SIZE      (1u << MEMO_BITS)
+#define MEMO_OPS       3                   // parameters of the widest CMD_PURE command
+
+typedef struct
+{
+	uint32_t cmd;                        // parseData[] slot plus one, 0 if empty
+	uint32_t op[MEMO_OPS];               // unused parameters are 0
+	uint32_t result;
+} MEMOENTRY;
+
+static MEMOENTRY memo[MEMO_SIZE];
+static uint32_t memoHits;
+static uint32_t memoMisses;
+
+extern volatile uint32_t rxDropped;
+extern volatile uint32_t rxOverruns;
+extern uint32_t lineDepthMax;
+extern uint32_t txWaitCycles;
 
 
 /*-------------------------------------------------------------------------
-   Use this for your fatRead() IO read buffer
+   type's read buffer, in two halves so "type -all" can read into one
+   while the other is still going out to the UART
 -------------------------------------------------------------------------*/
-uint8_t readBuffer [6*1024*1024];
-extern FileHandle HDDimage;
-int strcmp(const char *a, const char *b);
+#define TYPE_SHOW  100                     // bytes type shows from each end
+#define TYPE_CHUNK 2048                    // bytes in each half
+static uint8_t typeBuf[2][TYPE_CHUNK];
+static uint32_t diskCmds;                  // type and size since stats
+static uint32_t cmdLength(const char *word);
+PARSEDATA *findCmd(const char *word, uint32_t len);
+static uint32_t callParmAdapter(PARSEDATA *cmd, const CMDTOKENS *tokens);
+static void statCount(CMDSTATS *st, uint32_t rc, uint32_t tokCycles, uint32_t valCycles);
+static uint32_t floatOperand(const char *string, uint32_t len, uint32_t *value);
+static uint32_t memoCall(uint32_t x, uint32_t nOps, const uint32_t *val);
+uint32_t hexDecode(const char *string, uint32_t len, uint32_t *value);
 
 
 /*---------------------------------------------------------------------------
@@ -39,49 +265,326 @@ int strcmp(const char *a, const char *b);
 ---------------------------------------------------------------------------*/
 uint32_t parseCmdLine(char *InCmdLine)
 {
-	CMDPARM parms[MAX_PARMS+1];
+	CMDTOKENS tokens;
+	PARSEDATA *cmd;
+	CMDSTATS *st = &cmdStats[NUM_CMDS];
+	uint32_t x;
+	uint32_t len;
+	uint32_t last;
+	uint32_t start, tokDone, valDone, wait;
+	uint32_t wide = 0;
+	int rc = 0;
+
+	start = timer_cycles();
+	len = tokenizeCmdLine(InCmdLine, &tokens);
+	tokDone = timer_cycles();
+	if(len == 0) {
+		statLast = 0;
+		rc=0; goto ret; //blank line
+	}
+	cmd = findCmd(TOKPTR(&tokens, 0), tokens.tok[0].len);
+	if(cmd == 0) { rc=10; goto fail; } //command not found
+	x = cmd - parseData;
+	st = &cmdStats[x];
+	TRACE(TR_CMD_ID, x);
 
-	int i = 0;
+	if(tokens.count < cmd->NumParms) {
+		rc=1; goto fail; //not enough args
+	}
+	if(tokens.more && !(cmdExt[x].flags & CMD_WHOLE_LINE)) {
+		rc=10; goto fail; //more args than tok[] holds
+	}
+	last = (cmdExt[x].flags & CMD_VARIADIC) ? tokens.count : cmd->NumParms;
+	for(uint32_t n=1; n < last; n++) { //now validate parameters
+		len = tokens.tok[n].len;
+		if((cmdExt[x].flags & CMD_DECIMAL_OK) && floatOperand(TOKPTR(&tokens, n), len, &tokens.val[n])) {
+			continue; //8 hex digits or a decimal float
+		}
+		if(len > cmd->MaxParmLen || len < cmd->MinParmLen)  {
+			rc=2; goto fail; //invalid argument size
+		}
+		else if(cmd->EvenHexOnly == 1) {
+			len = hexDecode(TOKPTR(&tokens, n), len, &tokens.val[n]);
+			if(len == HEX_BAD_DIGIT || len == HEX_ODD_LEN) { rc=3;goto fail; } //invalid hex
+			wide |= (len == HEX_TOO_LONG); //val[n] only has the last 8 digits
+		}
+	}
+
+	valDone = timer_cycles();
+	wait = txWaitCycles;
+	if((cmdExt[x].flags & CMD_PURE) && !wide) {
+		cmdExt[x].outCall(memoCall(x, cmd->NumParms - 1, tokens.val));
+		rc = 0;
+	} else if(cmdExt[x].viewCall) {
+		rc = cmdExt[x].viewCall(&tokens); //validated and parsed
+	} else {
+		rc = callParmAdapter(cmd, &tokens);
+	}
+	st->phase[STAT_CALL] += timer_cycles() - valDone;
+	st->phase[STAT_TXWAIT] += txWaitCycles - wait;
+	goto count;
+
+	fail: valDone = timer_cycles();
+	count: statCount(st, rc, tokDone - start, valDone - tokDone);
+	ret: return rc;
+}
+
+
+/*---------------------------------------------------------------------------
+  This function runs one binary frame, see frame.h.  op is the parseData[]
+  slot and data holds len bytes of little endian operands, a word for each
+  parameter.  Only CMD_PURE commands take frames, the result goes back in
+  *result instead of being printed.  Returns the parseCmdLine() codes.
+---------------------------------------------------------------------------*/
+uint32_t parseFrame(uint32_t op, const uint8_t *data, uint32_t len, uint32_t *result)
+{
+	CMDSTATS *st = &cmdStats[NUM_CMDS];
+	uint32_t val[MEMO_OPS+1];
+	uint32_t nOps;
+	uint32_t start, valDone;
 	int rc = 0;
-	char *ptr;
-	for(int z = 0; z < MAX_PARMS+1 && *InCmdLine!='\0'; z++) {
-		ptr = parseSingleItem(InCmdLine, parms+z);
-		InCmdLine = ptr;
-		i++;
+
+	start = timer_cycles();
+	if(op >= NUM_CMDS || (cmdExt[op].flags & CMD_PURE) == 0) {
+		rc=10; goto fail; //no such op
+	}
+	st = &cmdStats[op];
+	TRACE(TR_CMD_ID, op);
+	nOps = parseData[op].NumParms - 1;
+	if(len < 4*nOps) { rc=1; goto fail; } //not enough args
+	if(len > 4*nOps) { rc=2; goto fail; }
+	for(uint32_t n = 0; n < nOps; n++) {
+		val[n+1] = frameWord(&data[4*n]);
+	}
+
+	valDone = timer_cycles();
+	*result = memoCall(op, nOps, val);
+	st->phase[STAT_CALL] += timer_cycles() - valDone;
+	goto count;
+
+	fail: valDone = timer_cycles();
+	count: statCount(st, rc, 0, valDone - start);
+	return rc;
+} // End parseFrame
+
+
+/*---------------------------------------------------------------------------
+  This function adds one parsed line to st: its return code and the cycles
+  spent tokenizing and validating.  statsLatency() finishes the record.
+---------------------------------------------------------------------------*/
+static void statCount(CMDSTATS *st, uint32_t rc, uint32_t tokCycles, uint32_t valCycles)
+{
+	static const uint8_t rcSlot[11] = { 0, 0, 1, 2, 5, 3, 5, 5, 5, 5, 4 };
+
+	st->count++;
+	st->phase[STAT_TOKENIZE] += tokCycles;
+	st->phase[STAT_VALIDATE] += valCycles;
+	if(rc != 0) {
+		st->errors[rc <= 10 ? rcSlot[rc] : 5]++;
 	}
+	statLast = st;
+} // End statCount
+
+
+/*---------------------------------------------------------------------------
+  This function records the cycles from the CR of the line parsed last
+  arriving to its output, error messages included, being queued.
+---------------------------------------------------------------------------*/
+void statsLatency(uint32_t cycles)
+{
+	if(statLast == 0) return;
+	statLast->lat[31 - __builtin_clz(cycles | 1)]++;
+} // End statsLatency
 
 
-	if(i > 0) {
-		for(int x=0; x < 6; x++) { //parse command logic
-			if(!strcmp(parms[0].parameter, parseData[x].ParmCmdStr)) {
+/*---------------------------------------------------------------------------
+  This function reads one operand of a CMD_DECIMAL_OK command.  Exactly 8
+  hex digits are taken as the bits of the float, as always, anything else
+  is tried as a decimal, so 13.125, -1e-7 and 41 are values while 41520000
+  stays hex.  Returns 1 with *value set, or 0 to report the usual hex errors.
+---------------------------------------------------------------------------*/
+static uint32_t floatOperand(const char *string, uint32_t len, uint32_t *value)
+{
+	if(len == 8 && hexDecode(string, len, value) == HEX_OK) return 1;
+	return IeeeParse(string, len, value);
+} // End floatOperand
+
+
+/*---------------------------------------------------------------------------
+  This function returns the result of CMD_PURE command x for its nOps
+  parameters in val[1..nOps].  It comes from the memo cache when the slot
+  the command and parameters hash to holds that same line, otherwise the
+  command's pureCall computes it and replaces the slot.
+---------------------------------------------------------------------------*/
+static uint32_t memoCall(uint32_t x, uint32_t nOps, const uint32_t *val)
+{
+#ifdef MEMO_DISABLE
+	(void)nOps;
+	return cmdExt[x].pureCall(val);
+#else
+	uint32_t op[MEMO_OPS] = { 0, 0, 0 };
+	uint32_t h = x + 1;
+	MEMOENTRY *e;
+
+	for(uint32_t i = 0; i < nOps; i++) {
+		op[i] = val[i+1];
+		h = (h ^ op[i]) * 0x9E3779B1u; //multiplicative hash, the top bits mix best
+	}
+	e = &memo[h >> (32 - MEMO_BITS)];
+	if(e->cmd == x+1 && e->op[0] == op[0] && e->op[1] == op[1] && e->op[2] == op[2]) {
+		memoHits++;
+		return e->result;
+	}
+	memoMisses++;
+	e->cmd = x+1;
+	e->op[0] = op[0];
+	e->op[1] = op[1];
+	e->op[2] = op[2];
+	e->result = cmdExt[x].pureCall(val);
+	return e->result;
+#endif
+} // End memoCall
 
-				if(countParms(parms) < parseData[x].NumParms) {
-					rc=1; goto ret; //not enough args
-				}
-				for(int n=1; n < parseData[x].NumParms; n++) { //now validate parameters
-					if( ((parms[n].len > parseData[x].MaxParmLen+1) || parms[n].len < parseData[x].MinParmLen) && parms[n].parameter[0] != '\0' )  {
-						rc=2; goto ret; //invalid argument size
-					}
-					else if(parseData[x].EvenHexOnly == 1) {
-						if(verifyHex(parms[n].parameter) == 0 || verifyHex(parms[n].parameter) % 2 !=0) { rc=3;goto ret; } //invalid hex
-					}
-				}
-				rc = parseData[x].callBack(parms); //validated and parsed
-				goto ret;
 
+/*---------------------------------------------------------------------------
+  This function splits line into blank separated tokens in a single pass.
+  Each token is recorded as an offset and length into line, at most
+  MAX_PARMS+1 tokens are kept.  more is set if the line goes on with
+  further tokens, so the caller can refuse it rather than drop them.
+  Returns the number of tokens kept, 0 for a blank line.
+---------------------------------------------------------------------------*/
+uint32_t tokenizeCmdLine(const char *line, CMDTOKENS *tokens)
+{
+	uint32_t i = 0;
+	uint32_t start;
+
+	tokens->line  = line;
+	tokens->count = 0;
+	while(line[i] != '\0' && tokens->count < MAX_PARMS+1) {
+		if(line[i] == 32) { //skip blanks between tokens
+			i++;
+			continue;
+		}
+		start = i;
+		while(line[i] != '\0' && line[i] != 32) {
+			i++;
+		}
+		tokens->tok[tokens->count].off = start;
+		tokens->tok[tokens->count].len = i - start;
+		tokens->count++;
+	}
+	while(line[i] == 32) {
+		i++;
+	}
+	tokens->more = (line[i] != '\0');
+	return tokens->count;
+} // End tokenizeCmdLine
+
+
+/*---------------------------------------------------------------------------
+  This function runs a PARSEDATA callBack that takes the CMDPARM array.
+  The token slices are copied into CMDPARM form here, only for commands
+  without a viewCall.
+---------------------------------------------------------------------------*/
+static uint32_t callParmAdapter(PARSEDATA *cmd, const CMDTOKENS *tokens)
+{
+	CMDPARM parms[MAX_PARMS+1];
+	uint32_t len;
+
+	for(uint32_t n = 0; n < MAX_PARMS+1; n++) {
+		len = 0;
+		if(n < tokens->count) {
+			len = tokens->tok[n].len;
+			if(len > MAX_PARM_LEN) len = MAX_PARM_LEN;
+			for(uint32_t c = 0; c < len; c++) {
+				parms[n].parameter[c] = TOKPTR(tokens, n)[c];
 			}
-			else if(parms[0].len == 0) { rc=0; goto ret;} else { rc=10; continue; } //command not yet found, iterate again
+		}
+		parms[n].parameter[len] = '\0';
+		parms[n].len = len;
+	}
+	return cmd->callBack(parms);
+} // End callParmAdapter
 
+
+/*---------------------------------------------------------------------------
+  This function returns the length of a command word, it never looks past
+  MAX_PARM_LEN characters.
+---------------------------------------------------------------------------*/
+static uint32_t cmdLength(const char *word)
+{
+	uint32_t len = 0;
+	while(len < MAX_PARM_LEN && word[len] != '\0') {
+		len++;
+	}
+	return len;
+} // End cmdLength
+
+
+/*---------------------------------------------------------------------------
+  This function hashes a command word of len characters into cmdIndex[].
+---------------------------------------------------------------------------*/
+static uint32_t cmdHash(const char *word, uint32_t len)
+{
+	uint32_t h = len;
+
+	for(uint32_t i = 0; i < len; i++) {
+		h = h*31 + (uint8_t)word[i];
+	}
+	return (h ^ (h >> 9)) & (CMD_HASH_SIZE-1);
+} // End cmdHash
+
+
+/*---------------------------------------------------------------------------
+  This function returns 1 if the len characters at word are exactly the
+  nul terminated command string cmdStr, it compares at most len characters.
+---------------------------------------------------------------------------*/
+static uint32_t cmdEqual(const char *word, uint32_t len, const char *cmdStr)
+{
+	for(uint32_t i = 0; i < len; i++) {
+		if(word[i] != cmdStr[i]) return 0;
+	}
+	return cmdStr[len] == '\0';
+} // End cmdEqual
+
+
+/*---------------------------------------------------------------------------
+  This function fills cmdIndex[] from parseData[].
+---------------------------------------------------------------------------*/
+static void buildCmdIndex(void)
+{
+	uint32_t h;
+	for(uint32_t x = 0; x < NUM_CMDS; x++) {
+		h = cmdHash(parseData[x].ParmCmdStr, cmdLength(parseData[x].ParmCmdStr));
+		while(cmdIndex[h] != 0) {
+			h = (h+1) & (CMD_HASH_SIZE-1);
 		}
+		cmdIndex[h] = x+1;
 	}
+	cmdIndexBuilt = 1;
+} // End buildCmdIndex
 
-	ret: return rc;
-}
 
-int strcmp(const char *a,const char *b){ //need strcmp
-  if (! (*a | *b)) return 0;
-  return (*a!=*b) ? *a-*b : strcmp(++a,++b);
-}
+/*---------------------------------------------------------------------------
+  This function looks up the len character command word and returns its
+  parseData[] entry or 0 if there is no such command.
+---------------------------------------------------------------------------*/
+PARSEDATA *findCmd(const char *word, uint32_t len)
+{
+	uint32_t h;
+	PARSEDATA *cmd;
+
+	if(len == 0) return 0;
+	if(!cmdIndexBuilt) buildCmdIndex();
+
+	h = cmdHash(word, len);
+	while(cmdIndex[h] != 0) {
+		cmd = &parseData[cmdIndex[h]-1];
+		if(cmdEqual(word, len, cmd->ParmCmdStr)) return cmd;
+		h = (h+1) & (CMD_HASH_SIZE-1);
+	}
+	return 0;
+} // End findCmd
 
 
 
@@ -145,43 +648,82 @@ char *parseSingleItem(char *inStringP, CMDPARM *singleParm)
 } // End parseSingleItem
 
 
+/*---------------------------------------------------------------------------
+  This function checks and converts 8 hex characters packed into w, the
+  first character in the low byte.  Each byte is range checked in parallel:
+  adding 0x80-c to a 7 bit byte sets its top bit exactly when the byte is
+  >= c, and nothing carries into the next byte.  The nibbles are then
+  merged pairwise into the 32 bit value.
+  Returns 1 if all 8 characters are hex digits, the value is always stored.
+---------------------------------------------------------------------------*/
+#define HEX_ONES   0x0101010101010101ULL
+#define HEX_HIGH   0x8080808080808080ULL
+#define HEX_GE(x, c) (((x) + (0x80-(c))*HEX_ONES) & HEX_HIGH)
+
+static uint32_t hexWord(uint64_t w, uint32_t *value)
+{
+	uint64_t lower, digit, alpha, v;
+
+	lower = w | 0x20*HEX_ONES; //fold A-F onto a-f
+	digit = HEX_GE(w, '0') & ~HEX_GE(w, '9'+1);
+	alpha = HEX_GE(lower, 'a') & ~HEX_GE(lower, 'f'+1);
+
+	v = (w & 0x0F*HEX_ONES) + (alpha >> 7)*9; //one nibble per byte
+	v = ((v & 0x000F000F000F000FULL) << 4) | ((v & 0x0F000F000F000F00ULL) >> 8);
+	v = ((v & 0x000000FF000000FFULL) << 8) | ((v & 0x00FF000000FF0000ULL) >> 16);
+	*value = (uint32_t)(((v & 0xFFFF) << 16) | ((v >> 32) & 0xFFFF));
+
+	return (w & HEX_HIGH) == 0 && (digit | alpha) == HEX_HIGH;
+} // End hexWord
+
+
+/*---------------------------------------------------------------------------
+  This function validates, counts and converts the len hex characters at
+  string in a single pass, 8 characters per step.  The string does not
+  need to be nul terminated.  A short first step is padded with '0' so
+  every step sees a full 64 bit word.
+  *value gets the last 8 digits, which is the whole number for tokens of
+  up to 8 digits.
+  Returns HEX_OK, HEX_BAD_DIGIT, HEX_ODD_LEN or HEX_TOO_LONG.
+---------------------------------------------------------------------------*/
+uint32_t hexDecode(const char *string, uint32_t len, uint32_t *value)
+{
+	uint64_t w;
+	uint32_t step, n, i;
+	uint32_t good = 1;
+
+	*value = 0;
+	if(len == 0) return HEX_BAD_DIGIT;
+
+	step = len & 7;
+	if(step == 0) step = 8;
+	for(n = 0; n < len; n += step, step = 8) {
+		w = (step == 8) ? 0 : (0x30*HEX_ONES) >> (8*step); //'0' padding
+		for(i = 8-step; i < 8; i++) {
+			w |= (uint64_t)(uint8_t)*string++ << (8*i);
+		}
+		good &= hexWord(w, value);
+	}
+
+	if(!good)     return HEX_BAD_DIGIT;
+	if(len & 1)   return HEX_ODD_LEN;
+	if(len > 8)   return HEX_TOO_LONG;
+	return HEX_OK;
+} // End hexDecode
+
+
 /*---------------------------------------------------------------------------
   This function validates that string only contains valid hex characters and
   returns the count of valid hex characters found or 0 for none.
 ---------------------------------------------------------------------------*/
 uint32_t verifyHex(const char *string)
 {
-	uint32_t i = 0;
-	while(*string != '\0') {
-		switch(*string) {
-			case '0': i++; break;
-			case '1': i++; break;
-			case '2': i++; break;
-			case '3': i++; break;
-			case '4': i++; break;
-			case '5': i++; break;
-			case '6': i++; break;
-			case '7': i++; break;
-			case '8': i++; break;
-			case '9': i++; break;
-			case 'A': i++; break;
-			case 'a': i++; break;
-			case 'B': i++; break;
-			case 'b': i++; break;
-			case 'C': i++; break;
-			case 'c': i++; break;
-			case 'D': i++; break;
-			case 'd': i++; break;
-			case 'E': i++; break;
-			case 'e': i++; break;
-			case 'F': i++; break;
-			case 'f': i++; break;
-			default: i=0; goto exit;
-
-		}
-		string++;
+	uint32_t len = 0;
+	uint32_t value;
+	while(string[len] != '\0') {
+		len++;
 	}
-	exit: return i;
+	return (hexDecode(string, len, &value) == HEX_BAD_DIGIT) ? 0 : len;
 } // End verifyHex
 
 
@@ -194,30 +736,13 @@ uint32_t verifyHex(const char *string)
 -------------------------------------------------------------------------- - */
 uint32_t char2Hex(const char *string)
 {
-
-	uint32_t retval = 0x0;
-	int v[8] = {0x10000000, 0x1000000, 0x100000, 0x10000, 0x1000, 0x100, 0x10, 0x1};
-	int i = 0;
-	int n;
-
-	while(*string != 0x00) {
-
-		n = *string;
-		if((n - 0x30) >= 0 && (n - 0x30) <=9 ) {  //if it's a number
-			retval += ( (n-0x30)*v[i] );
-		}
-		else if( (n - 0x41) >= 0 && (n - 0x41) <= 5) { //capital hex letter
-			retval = retval << 8; //shift right to make room for letter values
-			retval += ( v[i] *n );
-		}
-		else if((n-0x61) >= 0 && (n-0x61) <=5) { //lowercase hex letter
-			retval = retval << 8;
-			retval += ( v[i]*n ) ;
-		} else { break; }
-		i++;
-		++string;
+	uint32_t len = 0;
+	uint32_t value;
+	while(len < 8 && string[len] != '\0') {
+		len++;
 	}
-	return retval;
+	hexDecode(string, len, &value);
+	return value;
 } // End char2Hex
 
 /*---------------------------------------------------------------------------
@@ -235,10 +760,68 @@ uint32_t countParms(CMDPARM *parms)
 
 
 
+/*---------------------------------------------------------------------------
+  This function maps a fat.c result to the return codes printed by uart.c.
+  A disk that can't be read or holds no FAT volume is a "Disk Error".
+---------------------------------------------------------------------------*/
+static uint32_t fatCmdRc(uint32_t fatRc)
+{
+	static const uint8_t rc[] = { 0, 6, 6, 5, 10, 6 }; //FAT_OK ... FAT_BAD_CHAIN
+
+	return rc[fatRc];
+} // End fatCmdRc
+
+
+/*---------------------------------------------------------------------------
+  Mounts hddDev for type or size, which fat.c only does the first time,
+  and counts the command for the sectors per command in stats
+---------------------------------------------------------------------------*/
+static uint32_t diskMount(void)
+{
+	diskCmds++;
+	return fatCmdRc(fatMount(&hddDev));
+} // End diskMount
+
+
+/*---------------------------------------------------------------------------
+  This function sends the rest of file to the UART through typeBuf[].
+  Each half is queued as far as the transmit buffer has room, the next
+  chunk is read into the other half while that drains and only then does
+  the remainder wait for room, so the UART keeps sending during the read.
+  A disk that maps its sectors needs neither half, fatMap() gives the file
+  a cluster at a time where it lies.
+---------------------------------------------------------------------------*/
+static uint32_t typeAll(FATFILE *file)
+{
+	const uint8_t *mapped;
+	uint32_t len[2];
+	uint32_t cur = 0;
+	uint32_t sent;
+
+	while((mapped = fatMap(file, file->size, &sent)) != 0) {
+		uartWrite((const char *)mapped, sent);
+	}
+	len[0] = fatRead(file, typeBuf[0], TYPE_CHUNK);
+	while(len[cur] != 0) {
+		sent = uartWriteSome((const char *)typeBuf[cur], len[cur]);
+		len[cur ^ 1] = fatRead(file, typeBuf[cur ^ 1], TYPE_CHUNK);
+		uartWrite((const char *)typeBuf[cur] + sent, len[cur] - sent);
+		cur ^= 1;
+	}
+	if(file->err != FAT_OK) return fatCmdRc(file->err);
+	uartPutStr("\n\r\0");
+	return(0);
+} // End typeAll
+
+
 /*---------------------------------------------------------------------------
   This function is called when the parser determines the command is a "type"
-  command.  It will contain a call to your HDD "type" library.
-  Only the first 100 an last 100 bytes need to be displayed.
+  command.  The root directory file is read through fat.c, which mounts
+  hddDev the first time.  Only the first 100 and last 100 bytes are
+  displayed, a file of up to 200 bytes is displayed whole.  Between them
+  fatSeek() follows the cluster chain without reading any data, so a big
+  file costs its FAT entries, not its size.  "type -all" sends the whole
+  file, see typeAll().
   This returns 0 for success, non-zero for error
 
   Typical commands:
@@ -247,62 +830,66 @@ uint32_t countParms(CMDPARM *parms)
   �      type      two.txt     �  �not found�
   � type  �                           �syntax error�
     �type TWO.TXT TWO.TXT�            �syntax error�
+    type -all TWO.TXT                all of TWO.TXT
 ---------------------------------------------------------------------------*/
 uint32_t typeCall(CMDPARM *parms)
 {
-	//None of the FAT functions appear to be implemented anywhere, just defined in the header
-	//So I have no idea if these work
-	/*
-	initHDD();
-	FileHandle *handle;
-	FAT_DirEntry *file = searchDir(parms[1].parameter);
-	if(!file) { return 5; } //file not found error
-	handle = (FileHandle*) fatOpen(parms[1].parameter, handle);
-	fatRead(handle, readBuffer, 100);
-	uartPutStr("First 100 bytes:\n\r\0");
-	uartPutStr((const char *)readBuffer);
-	uartPutStr("\n\r\0");
-	int n = 0;
-	while(fatRead(handle, readBuffer, 1024*1024*6)) {
-		continue;
-	}
-	while(*readBuffer != '\0') {
-		n++;
-	}
-	uartPutStr("Last 100 bytes:\n\r\0");
-	uartPutStr((const char *) readBuffer[n-100]);
-	uartPutStr("\n\r\0");*/
+	FATFILE file;
+	uint32_t all = cmdEqual(parms[1].parameter, parms[1].len, "-all");
+	const CMDPARM *name = &parms[1 + all];
+	uint32_t rc;
+	uint32_t len;
 
+	if(name->len == 0) return(1); //type -all
+	if(parms[2 + all].len != 0) return(10); //one file only
+	rc = diskMount();
+	if(rc == 0) rc = fatCmdRc(fatOpen(name->parameter, name->len, &file));
+	if(rc != 0) return rc;
+	if(all) return typeAll(&file);
 
-    return(0);
+	if(file.size <= 2*TYPE_SHOW) { //small enough to show all of it
+		len = fatRead(&file, typeBuf[0], file.size);
+		if(file.err != FAT_OK) return fatCmdRc(file.err);
+		uartWrite((const char *)typeBuf[0], len);
+		uartPutStr("\n\r\0");
+		return(0);
+	}
+	fatRead(&file, typeBuf[0], TYPE_SHOW);
+	fatSeek(&file, file.size - TYPE_SHOW); //only the FAT is read on the way
+	fatRead(&file, typeBuf[1], TYPE_SHOW);
+	if(file.err != FAT_OK) return fatCmdRc(file.err);
+	uartPutStr("First 100 bytes:\n\r\0");
+	uartWrite((const char *)typeBuf[0], TYPE_SHOW);
+	uartPutStr("\n\rLast 100 bytes:\n\r\0");
+	uartWrite((const char *)typeBuf[1], TYPE_SHOW);
+	uartPutStr("\n\r\0");
+	return(0);
 } // End typeCall
 
 
 /*---------------------------------------------------------------------------
   This function is called when the parser determines the command is a "size"
-  command.  It will contain a call to your HDD "type" library.
+  command.  The size comes from the file's root directory entry.
 
   �size TWOO.TXT  �           �not found�
   �size TWO.TXT  �            the file size of TWO.TXT: �5762 bytes�
   -------------------------------------------------------------------------*/
 uint32_t sizeCall(CMDPARM *parms)
 {
+	FATDIRENT file;
+	uint8_t buff[11];
+	uint32_t rc;
 
-	//None of the FAT functions appear to be implemented anywhere, just defined in the header
-	//So I have no idea if these work
-	/*
-	initHDD();
-	uint8_t buff[8];
-	FAT_DirEntry *file = searchDir(parms[1].parameter);
-	if(!file) { return 5; } //file not found error
-	decStr(file->FileSize, buff);
+	rc = diskMount();
+	if(rc == 0) rc = fatCmdRc(searchDir(parms[1].parameter, parms[1].len, &file));
+	if(rc != 0) return rc;
+	decStr(file.size, buff);
 	uartPutStr("The file size of \0");
 	uartPutStr(parms[1].parameter);
 	uartPutStr(": \0");
 	uartPutStr((const char *)buff);
-	uartPutStr("bytes.\n\r\0");*/
-
-    return(0);
+	uartPutStr(" bytes.\n\r\0");
+	return(0);
 } // End sizeCall
 
 
@@ -316,39 +903,86 @@ uint32_t sizeCall(CMDPARM *parms)
   �hex �                          �syntax error�
   �hex  1234qqq�                  �syntax error�
 ---------------------------------------------------------------------------*/
-uint32_t hexCall(CMDPARM *parms)
+uint32_t hexView(const CMDTOKENS *tokens)
 {
 
   //Implemented this anyway, oops.
-	char *p;
-	char ans[5];
-	p = ans;
-	uint32_t curr = 0x0;
-
-	curr = char2Hex(parms[1].parameter);
-	uint32_t nibbles;
-	int i = 0;
+	char ans[MAX_PARM_LEN/2+1];
+	char *p = ans;
+	const char *digits = TOKPTR(tokens, 1);
+	uint32_t len = tokens->tok[1].len;
+	uint32_t step, curr;
 
-	while(i < 4) {
-		nibbles = (curr >> (24-(8 * i))); //shift each byte into position
-		if(nibbles==0) { //if 0 try again
-			i++;
-		} else {
-			*p= (char)nibbles;
-			i++;
-			++p;
+	for(uint32_t n = 0; n < len; n += step) { //8 digits, 4 bytes at a time
+		step = (len - n < 8) ? len - n : 8;
+		hexDecode(digits + n, step, &curr);
+		for(int i = step/2 - 1; i >= 0; i--) {
+			if((curr >> (8*i)) & 0xFF) { //skip the nul bytes
+				*p++ = (char)(curr >> (8*i));
+			}
 		}
 	}
-	if(i==0) {
-		return 3; //invalid hex
-	}
 
 	uartPutStr("The string: \0");
 	*p = '\0';
 	uartPutStr(ans);
 	uartPutStr("\n\r\0");
     return(0);
-} // End hexCall
+} // End hexView
+
+
+/*---------------------------------------------------------------------------
+  These are "hex" as a CMD_PURE command, for up to 8 digits.  The decoded
+  value is the result and hexOut() prints its non nul bytes, first digit
+  pair first, the same as hexView().
+---------------------------------------------------------------------------*/
+uint32_t hexPure(const uint32_t *val)
+{
+	return val[1];
+} // End hexPure
+
+void hexOut(uint32_t bytes)
+{
+	char ans[5];
+	char *p = ans;
+
+	for(int i = 3; i >= 0; i--) {
+		if((bytes >> (8*i)) & 0xFF) { //skip the nul bytes
+			*p++ = (char)(bytes >> (8*i));
+		}
+	}
+	*p = '\0';
+	uartPutStr("The string: \0");
+	uartPutStr(ans);
+	uartPutStr("\n\r\0");
+} // End hexOut
+
+
+/*---------------------------------------------------------------------------
+  Output mode of fmul, fadd, fenc and ffma, set by the "fout" command.  The
+  batch commands always answer in hex.
+---------------------------------------------------------------------------*/
+static uint32_t fltDecimal = 0;
+
+/*---------------------------------------------------------------------------
+  This function prints one float result as hex, or as the shortest decimal
+  that reads back as the same value when fltDecimal is set.
+---------------------------------------------------------------------------*/
+static void fltReply(IEEE_FLT res)
+{
+	char buf[FMT_FLT_LEN+1];
+	uint32_t len;
+
+	if(!fltDecimal) {
+		uartHexStrings(res);
+		uartPutStr("\n\r\0");
+		return;
+	}
+	len = fmtFlt(res, buf);
+	buf[len++] = '\n';
+	buf[len++] = '\r';
+	uartWrite(buf, len);
+} // End fltReply
 
 
 /*---------------------------------------------------------------------------
@@ -356,24 +990,23 @@ uint32_t hexCall(CMDPARM *parms)
   command.  It will contain a call to your math  "fmul" library.
 
   �  fmul  41520000    41520000      �    432c4400
-  �  fmul 12345678     7654321�       error message : �second hex number invalid�
-  �  fmul 1234568     87654321�       error message : �first hex number invalid�
-  �  fmul 1234568     7654321�        error message : �both hex numbers invalid�
-  �  fmul 1234568     �               �syntax error�
-  �  fmul  �                      �syntax error�
+  �  fmul 41520000    1.5�            419D8000
+  �  fmul 12345678.0  1�              4B3C614E
+  �  fmul 12345678    7654321�        1DA48D57, 12345678 is hex
+  �  fmul 1234567g    3f800000�       Invalid Hex Argument
+  �  fmul 41520000    1.5.2�          Invalid Argument Size.
+  �  fmul 1234568     �               Too Few Arguments.
+
+  An operand is taken as hex only when it is exactly 8 hex digits, the
+  raw bits of the float.  Any other operand is read as a decimal, see
+  floatOperand(), so 12345678 is the hex word 0x12345678, not twelve
+  million, while 1234568 is the decimal 1234568.  Write 12345678.0 for
+  the decimal.
 ---------------------------------------------------------------------------*/
-uint32_t fmulCall(CMDPARM *parms)
+uint32_t fmulPure(const uint32_t *val)
 {
-	IEEE_FLT a;
-	IEEE_FLT b;
-	IEEE_FLT res;
-	a = char2Hex(parms[1].parameter);
-	b = char2Hex(parms[2].parameter);
-	res = IeeeMult(a, b);
-	uartHexStrings(res);
-	uartPutStr("\n\r\0");
-    return(0);
-} // End fmulCall
+	return IeeeMult(val[1], val[2]);
+} // End fmulPure
 
 
 /*---------------------------------------------------------------------------
@@ -381,24 +1014,20 @@ uint32_t fmulCall(CMDPARM *parms)
   command.  It will contain a call to your math "fadd" library.
 
   �  fadd 41520000  41520000� 41d20000
-  �  fadd 12345678     7654321�   error message : �second hex number invalid�
-  �  fadd 1234568     87654321�   error message : �first hex number invalid�
-  �  fadd 1234568     7654321�    error message : �both hex numbers invalid�
-  �  fadd 1234568     �           �syntax error�
-  �  fadd  �                  �syntax error�
+  �  fadd 41520000    -13.125�        00000000
+  �  fadd 12345678.0  1�              4B3C614F
+  �  fadd 12345678    7654321�        4AE99762, 12345678 is hex
+  �  fadd 1234567g    3f800000�       Invalid Hex Argument
+  �  fadd 41520000    1.5.2�          Invalid Argument Size.
+  �  fadd 1234568     �               Too Few Arguments.
+
+  Operands are read as for fmul, exactly 8 hex digits are the bits of
+  the float and anything else is a decimal.
 ---------------------------------------------------------------------------*/
-uint32_t faddCall(CMDPARM *parms)
+uint32_t faddPure(const uint32_t *val)
 {
-	IEEE_FLT a;
-	IEEE_FLT b;
-	IEEE_FLT res;
-	a = char2Hex(parms[1].parameter);
-	b = char2Hex(parms[2].parameter);
-	res = IeeeAdd(a, b);
-	uartHexStrings(res);
-	uartPutStr("\n\r\0");
-    return(0);
-} // End faddCmd
+	return IeeeAdd(val[1], val[2]);
+} // End faddPure
 
 
 /*---------------------------------------------------------------------------
@@ -406,18 +1035,401 @@ uint32_t faddCall(CMDPARM *parms)
   command.  It will contain a call to your math "fen c" library.
 
   �  fenc  FFFFFFF3  20000000        C1520000
-  �  fenc 12345678     7654321�   error message : �second hex number invalid�
-  �  fenc 1234568     87654321�   error message : �first hex number invalid�
-  �  fenc 1234568     7654321�    error message : �both hex numbers invalid�
-  �  fenc 1234568     �           �syntax error�
-  �  fenc  �                  �syntax error�
+  �  fenc 1234567g    20000000�       Invalid Hex Argument
+  �  fenc 12345678    7654321�        Invalid Argument Size.
+  �  fenc FFFFFFF3    �               Too Few Arguments.
+
+  Both operands are always 8 hex digits, the real and the fraction
+  words, fenc takes no decimals.
+---------------------------------------------------------------------------*/
+uint32_t fencPure(const uint32_t *val)
+{
+	INT_FRACT a = {val[1], val[2]};
+	return IeeeEncode(a);
+} // End fencPure
+
+
+/*---------------------------------------------------------------------------
+  These append a string, or value right aligned in width columns, at
+  buf[pos] and return the new position.
+---------------------------------------------------------------------------*/
+static uint32_t statStr(char *buf, uint32_t pos, const char *str)
+{
+	while(*str != '\0') buf[pos++] = *str++;
+	return pos;
+} // End statStr
+
+static uint32_t statNum(char *buf, uint32_t pos, uint64_t value, uint32_t width)
+{
+	char num[FMT_DEC_LEN];
+	uint32_t len;
+
+	len = fmtDec(value > 0xFFFFFFFF ? 0xFFFFFFFF : (uint32_t)value, num);
+	while(width-- > len) buf[pos++] = ' ';
+	return statStr(buf, pos, num);
+} // End statNum
+
+static uint32_t statHits(char *buf, uint32_t pos, const FATHITS *hits)
+{
+	pos = statNum(buf, pos, hits->hits, 0);
+	buf[pos++] = '/';
+	return statNum(buf, pos, hits->misses, 0);
+} // End statHits
+
+
+/*---------------------------------------------------------------------------
+  This function is called when the parser determines the command is a
+  "stats" command.  It prints the per command statistics, averages in
+  cycles, then the non-empty latency buckets as log2(cycles):count, and
+  clears them.  The receive counters run from power up.  The disk lines
+  are the sectors type and size read, on average, the lookups fat.c's
+  directory index answered and the hits and misses of its sector cache.
+
+  stats
+  cmd        count  rc1  rc2  rc3  rc5 rc10 rcX     tok     val    call  txwait
+  fmul          12    0    0    1    0    0   0      38     112     940       0
+    lat 10:3 11:9
+  ...
+  disk commands 14, sectors/cmd 1.5, dir index hits 13, builds 1
+  sector cache hits/misses fat 30/2, dir 41/4, data 9/9, extent hits 6
 ---------------------------------------------------------------------------*/
-uint32_t fencCall(CMDPARM *parms)
+uint32_t statsView(const CMDTOKENS *tokens)
+{
+	static const char rcNames[] = "  rc1  rc2  rc3  rc5 rc10 rcX";
+	char line[160];
+	const char *name;
+	static const FATSTATS fatNone;
+	CMDSTATS *st;
+	uint32_t pos, i, b;
+	uint64_t tenths;
+
+	pos = statStr(line, 0, "cmd        count");
+	pos = statStr(line, pos, rcNames);
+	pos = statStr(line, pos, "     tok     val    call  txwait\n\r");
+	uartWrite(line, pos);
+
+	for(i = 0; i <= NUM_CMDS; i++) {
+		st = &cmdStats[i];
+		if(st->count == 0) continue;
+		name = (i < NUM_CMDS) ? parseData[i].ParmCmdStr : "?";
+		pos = statStr(line, 0, name);
+		pos = statNum(line, pos, st->count, 16 - pos);
+		for(b = 0; b < STAT_RCS; b++) {
+			pos = statNum(line, pos, st->errors[b], b == STAT_RCS-1 ? 4 : 5);
+		}
+		for(b = 0; b < STAT_PHASES; b++) {
+			pos = statNum(line, pos, st->phase[b] / st->count, 8);
+		}
+		pos = statStr(line, pos, "\n\r  lat");
+		for(b = 0; b < STAT_BUCKETS; b++) {
+			if(st->lat[b] == 0) continue;
+			pos = statNum(line, pos, b, 3);
+			line[pos++] = ':';
+			pos = statNum(line, pos, st->lat[b], 0);
+			if(pos > sizeof(line) - 32) break;
+		}
+		pos = statStr(line, pos, "\n\r");
+		uartWrite(line, pos);
+	}
+
+	pos = statStr(line, 0, "line queue max");
+	pos = statNum(line, pos, lineDepthMax, 3);
+	pos = statStr(line, pos, ", rx dropped ");
+	pos = statNum(line, pos, rxDropped, 0);
+	pos = statStr(line, pos, ", rx overruns ");
+	pos = statNum(line, pos, rxOverruns, 0);
+	pos = statStr(line, pos, ", cycles/us ");
+	pos = statNum(line, pos, timer_cycles_per_us(), 0);
+	pos = statStr(line, pos, "\n\rmemo hits ");
+	pos = statNum(line, pos, memoHits, 0);
+	pos = statStr(line, pos, ", misses ");
+	pos = statNum(line, pos, memoMisses, 0);
+	pos = statStr(line, pos, "\n\r");
+	uartWrite(line, pos);
+
+	if(diskCmds != 0) {
+		tenths = (uint64_t)fatStats.devSectors * 10 / diskCmds;
+		pos = statStr(line, 0, "disk commands ");
+		pos = statNum(line, pos, diskCmds, 0);
+		pos = statStr(line, pos, ", sectors/cmd ");
+		pos = statNum(line, pos, tenths / 10, 0);
+		line[pos++] = '.';
+		pos = statNum(line, pos, tenths % 10, 0);
+		tenths = (uint64_t)fatStats.devMaps * 10 / diskCmds;
+		pos = statStr(line, pos, ", maps/cmd ");
+		pos = statNum(line, pos, tenths / 10, 0);
+		line[pos++] = '.';
+		pos = statNum(line, pos, tenths % 10, 0);
+		pos = statStr(line, pos, ", dir index hits ");
+		pos = statNum(line, pos, fatStats.indexHits, 0);
+		pos = statStr(line, pos, ", builds ");
+		pos = statNum(line, pos, fatStats.indexBuilds, 0);
+		pos = statStr(line, pos, "\n\r");
+		uartWrite(line, pos);
+		pos = statStr(line, 0, "sector cache hits/misses fat ");
+		pos = statHits(line, pos, &fatStats.fat);
+		pos = statStr(line, pos, ", dir ");
+		pos = statHits(line, pos, &fatStats.dir);
+		pos = statStr(line, pos, ", data ");
+		pos = statHits(line, pos, &fatStats.data);
+		pos = statStr(line, pos, ", extent hits ");
+		pos = statNum(line, pos, fatStats.extentHits, 0);
+		pos = statStr(line, pos, "\n\r");
+		uartWrite(line, pos);
+	}
+
+	// Start over, but keep counting this command
+	for(i = 0; i <= NUM_CMDS; i++) {
+		st = &cmdStats[i];
+		st->count = 0;
+		for(b = 0; b < STAT_RCS; b++) st->errors[b] = 0;
+		for(b = 0; b < STAT_PHASES; b++) st->phase[b] = 0;
+		for(b = 0; b < STAT_BUCKETS; b++) st->lat[b] = 0;
+	}
+	lineDepthMax = 0;
+	memoHits = 0;
+	memoMisses = 0;
+	diskCmds = 0;
+	fatStats = fatNone;
+	(void)tokens;
+	return(0);
+} // End statsView
+
+
+/*---------------------------------------------------------------------------
+  This function is called when the parser determines the command is a
+  "trace" command.  "dump" prints the event trace and empties it, "clear"
+  just empties it.  See host/tracedec.c for turning a dump into JSON.
+
+  trace dump
+  trace 2 700
+  0012A4F000080000 0012A61200090003
+  trace end
+---------------------------------------------------------------------------*/
+uint32_t traceView(const CMDTOKENS *tokens)
+{
+	if(cmdEqual(TOKPTR(tokens, 1), tokens->tok[1].len, "dump")) {
+		traceDump();
+	} else if(cmdEqual(TOKPTR(tokens, 1), tokens->tok[1].len, "clear")) {
+		traceClear();
+	} else {
+		return(10);
+	}
+	return(0);
+} // End traceView
+
+
+/*---------------------------------------------------------------------------
+  This function is called when the parser determines the command is a "ffma"
+  command.  It computes a * b + c with a single rounding.
+
+  ffma 41520000 41520000 3f800000      432D4400
+  ffma 3f800001 3f7fffff bf800000      337FFFFE   (fmul then fadd gives 0)
+  ffma 41520000 41520000               Too Few Arguments.
+---------------------------------------------------------------------------*/
+uint32_t ffmaPure(const uint32_t *val)
+{
+	return IeeeFma(val[1], val[2], val[3]);
+} // End ffmaPure
+
+
+/*---------------------------------------------------------------------------
+  This function is called when the parser determines the command is a "fdec"
+  command.  It prints the shortest decimal that reads back as the given
+  IEEE single, whatever the "fout" mode.
+
+  fdec 41520000                        13.125
+  fdec 3dcccccd                        0.1
+  fdec 00000001                        1E-45
+  fdec 7fc00000                        NaN
+---------------------------------------------------------------------------*/
+uint32_t fdecPure(const uint32_t *val)
+{
+	return val[1];
+} // End fdecPure
+
+void fdecOut(uint32_t bits)
+{
+	char buf[FMT_FLT_LEN+1];
+	uint32_t len;
+
+	len = fmtFlt(bits, buf);
+	buf[len++] = '\n';
+	buf[len++] = '\r';
+	uartWrite(buf, len);
+} // End fdecOut
+
+
+/*---------------------------------------------------------------------------
+  This function is called when the parser determines the command is a "fout"
+  command.  "dec" makes fmul, fadd, fenc and ffma print decimal results,
+  "hex", the default, puts them back to hex.
+
+  fout dec
+  fmul 41520000 41520000               172.26562
+---------------------------------------------------------------------------*/
+uint32_t foutView(const CMDTOKENS *tokens)
+{
+	if(cmdEqual(TOKPTR(tokens, 1), tokens->tok[1].len, "dec")) {
+		fltDecimal = 1;
+	} else if(cmdEqual(TOKPTR(tokens, 1), tokens->tok[1].len, "hex")) {
+		fltDecimal = 0;
+	} else {
+		return(10);
+	}
+	return(0);
+} // End foutView
+
+
+/*---------------------------------------------------------------------------
+  This function gathers the validated operands of a batch command as
+  pairs, a[i] from parameter 2i+1 and b[i] from 2i+2.  Returns the number
+  of pairs or 0 if the last operand has no partner.
+---------------------------------------------------------------------------*/
+static uint32_t batchPairs(const CMDTOKENS *tokens, IEEE_FLT *a, IEEE_FLT *b)
+{
+	uint32_t n;
+
+	if(((tokens->count - 1) & 1) != 0) return 0;
+	for(n = 0; n < (tokens->count - 1) / 2; n++) {
+		a[n] = tokens->val[2*n + 1];
+		b[n] = tokens->val[2*n + 2];
+	}
+	return n;
+} // End batchPairs
+
+
+/*---------------------------------------------------------------------------
+  This function prints n results as one line of hex words.
+---------------------------------------------------------------------------*/
+static void batchReply(const IEEE_FLT *z, uint32_t n)
+{
+	char line[(MAX_PARMS/2) * 9 + 2];
+	uint32_t pos = 0;
+
+	for(uint32_t i = 0; i < n; i++) {
+		pos += fmtHex(z[i], &line[pos]);
+		line[pos++] = ' ';
+	}
+	line[pos++] = '\n';
+	line[pos++] = '\r';
+	uartWrite(line, pos);
+} // End batchReply
+
+
+/*---------------------------------------------------------------------------
+  These functions are called when the parser determines the command is a
+  "fmulv", "faddv" or "fencv" command.  They take up to MAX_PARMS/2
+  operand pairs, run them through the batch kernel in ieee.c and answer
+  with one line.  fencv pairs are real and fraction as for fenc.  More
+  pairs than that is a Syntax Error, none of them are run.
+
+  fmulv 41520000 41520000 3f800000 3f000000    432C4400 3F000000
+  faddv 41520000 41520000 3f800000             Too Few Arguments.
+  faddv 1 2 3 4 5 6 7 8 9 10                   Syntax Error
+---------------------------------------------------------------------------*/
+uint32_t fmulvView(const CMDTOKENS *tokens)
+{
+	IEEE_FLT a[MAX_PARMS/2], b[MAX_PARMS/2], z[MAX_PARMS/2];
+	uint32_t n = batchPairs(tokens, a, b);
+
+	if(n == 0) return(1);
+	IeeeMultV(a, b, z, n);
+	batchReply(z, n);
+	return(0);
+} // End fmulvView
+
+uint32_t faddvView(const CMDTOKENS *tokens)
+{
+	IEEE_FLT a[MAX_PARMS/2], b[MAX_PARMS/2], z[MAX_PARMS/2];
+	uint32_t n = batchPairs(tokens, a, b);
+
+	if(n == 0) return(1);
+	IeeeAddV(a, b, z, n);
+	batchReply(z, n);
+	return(0);
+} // End faddvView
+
+uint32_t fencvView(const CMDTOKENS *tokens)
+{
+	IEEE_FLT a[MAX_PARMS/2], b[MAX_PARMS/2], z[MAX_PARMS/2];
+	INT_FRACT in[MAX_PARMS/2];
+	uint32_t n = batchPairs(tokens, a, b);
+
+	if(n == 0) return(1);
+	for(uint32_t i = 0; i < n; i++) {
+		in[i].real     = a[i];
+		in[i].fraction = b[i];
+	}
+	IeeeEncodeV(in, z, n);
+	batchReply(z, n);
+	return(0);
+} // End fencvView
+
+
+/*---------------------------------------------------------------------------
+  This function is called when the parser determines the command is a
+  "fparse" command.  It prints the IEEE single nearest to a decimal, which
+  is what fmul, fadd, ffma, fmulv and faddv use for a decimal operand.
+
+  fparse 13.125                        41520000
+  fparse -1e-7                         B3D6BF95
+  fparse 0.1                           3DCCCCCD
+  fparse 1e39                          7F800000
+  fparse 1.2.3                         Syntax Error
+---------------------------------------------------------------------------*/
+uint32_t fparseView(const CMDTOKENS *tokens)
 {
-	INT_FRACT a = {char2Hex(parms[1].parameter), char2Hex(parms[2].parameter)};
 	IEEE_FLT res;
-	res = IeeeEncode(a);
-    uartHexStrings(res);
+
+	if(!IeeeParse(TOKPTR(tokens, 1), tokens->tok[1].len, &res)) return(10);
+	uartHexStrings(res);
 	uartPutStr("\n\r\0");
-    return(0);
-} // End fencCmd
+	return(0);
+} // End fparseView
+
+
+/*---------------------------------------------------------------------------
+  This function is called when the parser determines the command is a "calc"
+  command.  The rest of the line is compiled as one expression, see calc.h,
+  and run, and only the result is printed, in the "fout" format.  The
+  registers a - z keep their values between lines.
+
+  calc x = 1.5 * 41520000               419D8000
+  calc (x * x) + (2 * -3)               43BECC80
+  calc fma(x, x, ans)                   44404C80
+  calc x * * 2                          Syntax Error
+---------------------------------------------------------------------------*/
+uint32_t calcView(const CMDTOKENS *tokens)
+{
+	CALCPROG prog;
+	const char *text = TOKPTR(tokens, 1);
+	uint32_t len = 0;
+
+	while(text[len] != '\0') {
+		len++;
+	}
+	if(calcCompile(text, len, &prog) != CALC_OK) return(10);
+	fltReply(calcRun(&prog));
+	return(0);
+} // End calcView
+
+
+/*---------------------------------------------------------------------------
+  This function is called when the parser determines the command is a "mode"
+  command.  "bin" switches the link to binary frames, see frame.h, and is
+  answered with an empty FRAME_OP_MODE frame rather than text.  "ascii" is
+  the mode already in use.  A FRAME_OP_MODE frame comes back from binary.
+
+  mode bin                             A5 10 00 00 FF 8F
+  mode tty                             Syntax Error
+---------------------------------------------------------------------------*/
+uint32_t modeView(const CMDTOKENS *tokens)
+{
+	if(cmdEqual(TOKPTR(tokens, 1), tokens->tok[1].len, "bin")) {
+		uartFrameMode(1);
+	} else if(!cmdEqual(TOKPTR(tokens, 1), tokens->tok[1].len, "ascii")) {
+		return(10);
+	}
+	return(0);
+} // End modeView
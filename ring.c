@@ -0,0 +1,137 @@
+//-------------------------------------------------------------------------
+// ring.c
+// Lock free single producer / single consumer byte ring, see ring.h
+// 10/18/2026 - Initial version
+//-------------------------------------------------------------------------
+
+#include <stdint.h>
+#include "ring.h"
+
+#define LOAD_OWN(p)        __atomic_load_n((p), __ATOMIC_RELAXED)
+#define LOAD_OTHER(p)      __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define PUBLISH(p, value)  __atomic_store_n((p), (value), __ATOMIC_RELEASE)
+
+
+/*---------------------------------------------------------------------------
+  Set up a ring over buf, size must be a power of 2
+---------------------------------------------------------------------------*/
+void ring_init(RING *ring, uint8_t *buf, uint32_t size)
+   {
+   ring->buf  = buf;
+   ring->mask = size - 1;
+   ring_reset(ring);
+   } // End ring_init()
+
+
+/*---------------------------------------------------------------------------
+  Empty the ring, only safe while neither side is using it
+---------------------------------------------------------------------------*/
+void ring_reset(RING *ring)
+   {
+   PUBLISH(&ring->head, 0);
+   PUBLISH(&ring->tail, 0);
+   } // End ring_reset()
+
+
+/*---------------------------------------------------------------------------
+  Bytes waiting to be read, and room left to write.  Either side may ask,
+  the answer is exact for the consumer's count and the producer's space.
+---------------------------------------------------------------------------*/
+uint32_t ring_count(RING *ring)
+   {
+   return LOAD_OTHER(&ring->head) - LOAD_OTHER(&ring->tail);
+   } // End ring_count()
+
+uint32_t ring_space(RING *ring)
+   {
+   return ring->mask + 1 - ring_count(ring);
+   } // End ring_space()
+
+
+/*---------------------------------------------------------------------------
+  Add one byte, returns 0 if the ring is full
+---------------------------------------------------------------------------*/
+uint32_t ring_put(RING *ring, uint8_t byte)
+   {
+   uint32_t head = LOAD_OWN(&ring->head);
+
+   if (head - LOAD_OTHER(&ring->tail) > ring->mask) return 0;
+   ring->buf[head & ring->mask] = byte;
+   PUBLISH(&ring->head, head + 1);
+   return 1;
+   } // End ring_put()
+
+
+/*---------------------------------------------------------------------------
+  Returns the contiguous free region starting at head in *data and its
+  length, which stops at the end of the buffer.  Fill it and then call
+  ring_commit() with the number of bytes written.
+---------------------------------------------------------------------------*/
+uint32_t ring_write_span(RING *ring, uint8_t **data)
+   {
+   uint32_t head  = LOAD_OWN(&ring->head);
+   uint32_t space = ring->mask + 1 - (head - LOAD_OTHER(&ring->tail));
+   uint32_t toEnd = ring->mask + 1 - (head & ring->mask);
+
+   *data = &ring->buf[head & ring->mask];
+   return (space < toEnd) ? space : toEnd;
+   } // End ring_write_span()
+
+void ring_commit(RING *ring, uint32_t len)
+   {
+   PUBLISH(&ring->head, LOAD_OWN(&ring->head) + len);
+   } // End ring_commit()
+
+
+/*---------------------------------------------------------------------------
+  Copy in as much of data as fits, returns the number of bytes written
+---------------------------------------------------------------------------*/
+uint32_t ring_write(RING *ring, const uint8_t *data, uint32_t len)
+   {
+   uint8_t *span;
+   uint32_t n, i, done = 0;
+
+   while (done < len && (n = ring_write_span(ring, &span)) != 0)
+      {
+      if (n > len - done) n = len - done;
+      for (i = 0; i < n; i++) span[i] = data[done + i];
+      ring_commit(ring, n);
+      done += n;
+      }
+   return done;
+   } // End ring_write()
+
+
+/*---------------------------------------------------------------------------
+  Remove one byte, returns 0 if the ring is empty
+---------------------------------------------------------------------------*/
+uint32_t ring_get(RING *ring, uint8_t *byte)
+   {
+   uint32_t tail = LOAD_OWN(&ring->tail);
+
+   if (tail == LOAD_OTHER(&ring->head)) return 0;
+   *byte = ring->buf[tail & ring->mask];
+   PUBLISH(&ring->tail, tail + 1);
+   return 1;
+   } // End ring_get()
+
+
+/*---------------------------------------------------------------------------
+  Returns the contiguous readable region starting at tail in *data and its
+  length, which stops at the end of the buffer.  The bytes stay in the ring
+  until ring_consume() releases them.
+---------------------------------------------------------------------------*/
+uint32_t ring_read_span(RING *ring, const uint8_t **data)
+   {
+   uint32_t tail  = LOAD_OWN(&ring->tail);
+   uint32_t count = LOAD_OTHER(&ring->head) - tail;
+   uint32_t toEnd = ring->mask + 1 - (tail & ring->mask);
+
+   *data = &ring->buf[tail & ring->mask];
+   return (count < toEnd) ? count : toEnd;
+   } // End ring_read_span()
+
+void ring_consume(RING *ring, uint32_t len)
+   {
+   PUBLISH(&ring->tail, LOAD_OWN(&ring->tail) + len);
+   } // End ring_consume()
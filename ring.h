@@ -0,0 +1,46 @@
+//-------------------------------------------------------------------------
+// ring.h
+// Lock free single producer / single consumer byte ring.  One side (for
+// example an interrupt handler) only ever adds bytes, the other only ever
+// removes them.  head and tail are free running counters on their own
+// cache lines; the producer publishes head with release ordering and the
+// consumer publishes tail the same way, each side reads the other's index
+// with acquire ordering.
+// 10/18/2026 - Initial version
+//-------------------------------------------------------------------------
+
+#ifndef RING_H
+#define RING_H
+
+#include <stdint.h>
+
+#define RING_CACHE_LINE 64
+
+typedef struct
+   {
+   uint32_t head __attribute__((aligned(RING_CACHE_LINE)));   // producer
+   uint32_t tail __attribute__((aligned(RING_CACHE_LINE)));   // consumer
+   uint8_t *buf  __attribute__((aligned(RING_CACHE_LINE)));
+   uint32_t mask;                          // size - 1, size is a power of 2
+   } RING;
+
+// Static initializer over an array whose size is a power of 2
+#define RING_INIT(array) { .head = 0, .tail = 0, .buf = (array), .mask = sizeof(array) - 1 }
+
+void     ring_init(RING *ring, uint8_t *buf, uint32_t size);
+void     ring_reset(RING *ring);
+uint32_t ring_count(RING *ring);
+uint32_t ring_space(RING *ring);
+
+// Producer side
+uint32_t ring_put(RING *ring, uint8_t byte);
+uint32_t ring_write(RING *ring, const uint8_t *data, uint32_t len);
+uint32_t ring_write_span(RING *ring, uint8_t **data);
+void     ring_commit(RING *ring, uint32_t len);
+
+// Consumer side
+uint32_t ring_get(RING *ring, uint8_t *byte);
+uint32_t ring_read_span(RING *ring, const uint8_t **data);
+void     ring_consume(RING *ring, uint32_t len);
+
+#endif // RING_H
@@ -0,0 +1,131 @@
+//-------------------------------------------------------------------------
+// timer.c
+// Delays and timestamps, see timer.h
+// 10/18/2026 - Initial version
+//-------------------------------------------------------------------------
+
+#include <stdint.h>
+#include "mmio.h"
+#include "timer.h"
+
+#define CALIBRATE_US     1000             // timer_init() measures this long
+
+static uint32_t cyclesPerUs;
+
+#ifdef HOST_SIM
+
+#include <time.h>
+
+static uint64_t hostNs(void)
+   {
+   struct timespec ts;
+
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+   } // End hostNs()
+
+static void cyclesStart(void)
+   {
+   } // End cyclesStart()
+
+uint32_t timer_cycles(void)
+   {
+   return (uint32_t)hostNs();
+   } // End timer_cycles()
+
+uint64_t timer_us(void)
+   {
+   return hostNs() / 1000;
+   } // End timer_us()
+
+#else
+
+// BCM2835 system timer, counter low and high words
+#define ST_CLO           0x20003004
+#define ST_CHI           0x20003008
+
+/*---------------------------------------------------------------------------
+  ARM1176 performance monitor control, c15 c12 0.  Bit 0 enables the
+  counters, bit 2 resets the cycle counter, bit 3 clear counts every cycle.
+---------------------------------------------------------------------------*/
+static void cyclesStart(void)
+   {
+   uint32_t pmnc = 0x5;
+
+   __asm__ volatile ("mcr p15, 0, %0, c15, c12, 0" : : "r" (pmnc));
+   } // End cyclesStart()
+
+uint32_t timer_cycles(void)
+   {
+   uint32_t ccnt;
+
+   __asm__ volatile ("mrc p15, 0, %0, c15, c12, 1" : "=r" (ccnt));
+   return ccnt;
+   } // End timer_cycles()
+
+/*---------------------------------------------------------------------------
+  The two halves are separate reads, try again if the low word wrapped in
+  between
+---------------------------------------------------------------------------*/
+uint64_t timer_us(void)
+   {
+   uint32_t hi, lo;
+
+   do
+      {
+      hi = REG_READ(ST_CHI);
+      lo = REG_READ(ST_CLO);
+      } while (hi != REG_READ(ST_CHI));
+   return ((uint64_t)hi << 32) | lo;
+   } // End timer_us()
+
+#endif
+
+
+/*---------------------------------------------------------------------------
+  Start the cycle counter and measure it against the microsecond clock
+---------------------------------------------------------------------------*/
+void timer_init(void)
+   {
+   uint64_t start;
+   uint32_t cycles;
+
+   cyclesStart();
+   start = timer_us();
+   while (timer_us() == start) ;          // line up with a tick
+
+   start  = timer_us();
+   cycles = timer_cycles();
+   while (timer_us() - start < CALIBRATE_US) ;
+   cyclesPerUs = (timer_cycles() - cycles) / CALIBRATE_US;
+   if (cyclesPerUs == 0) cyclesPerUs = 1;
+   } // End timer_init()
+
+uint32_t timer_cycles_per_us(void)
+   {
+   return cyclesPerUs;
+   } // End timer_cycles_per_us()
+
+
+/*---------------------------------------------------------------------------
+  Busy waits, both bounded by the clock rather than by loop speed
+---------------------------------------------------------------------------*/
+void delay_cycles(uint32_t cycles)
+   {
+   uint32_t start = timer_cycles();
+
+   while (timer_cycles() - start < cycles)
+      {
+      REG_IDLE();
+      }
+   } // End delay_cycles()
+
+void delay_us(uint32_t us)
+   {
+   uint64_t start = timer_us();
+
+   while (timer_us() - start < us)
+      {
+      REG_IDLE();
+      }
+   } // End delay_us()
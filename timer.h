@@ -0,0 +1,23 @@
+//-------------------------------------------------------------------------
+// timer.h
+// Delays and timestamps.  Firmware builds use the ARM1176 cycle counter
+// for short waits and profiling, and the free running 1 MHz BCM2835
+// system timer for microseconds.  Host builds (-DHOST_SIM) use
+// clock_gettime(), one "cycle" being a nanosecond there.
+// 10/18/2026 - Initial version
+//-------------------------------------------------------------------------
+
+#ifndef TIMER_H
+#define TIMER_H
+
+#include <stdint.h>
+
+void     timer_init(void);
+uint32_t timer_cycles(void);              // wraps, subtract to get a span
+uint64_t timer_us(void);                  // monotonic since power up
+uint32_t timer_cycles_per_us(void);       // measured by timer_init()
+
+void     delay_cycles(uint32_t cycles);
+void     delay_us(uint32_t us);
+
+#endif // TIMER_H
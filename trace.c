@@ -0,0 +1,94 @@
+//-------------------------------------------------------------------------
+// trace.c
+// Binary event trace, see trace.h
+// 10/18/2026 - Initial version
+//-------------------------------------------------------------------------
+
+#include <stdint.h>
+#include "trace.h"
+#include "timer.h"
+#include "fmt.h"
+
+void uartWrite(const char *buf, uint32_t len);
+
+static TRACEREC traceBuf [TRACE_SIZE];
+static uint32_t traceHead;                // free running, next slot to claim
+static volatile uint32_t traceOff;        // set while dumping
+
+
+/*---------------------------------------------------------------------------
+  Adds one record.  The slot is claimed before it is filled, so an
+  interrupt arriving in between gets the next slot and its record can
+  carry an earlier timestamp; the decoder sorts by time.
+---------------------------------------------------------------------------*/
+void traceEvent(uint32_t event, uint32_t arg)
+   {
+   TRACEREC *rec;
+
+   if (traceOff) return;
+   rec = &traceBuf [__atomic_fetch_add(&traceHead, 1, __ATOMIC_RELAXED) & (TRACE_SIZE-1)];
+   rec->stamp = timer_cycles();
+   rec->event = event;
+   rec->arg   = arg;
+   } // End traceEvent()
+
+
+/*---------------------------------------------------------------------------
+  Prints the records oldest first, four per line as 16 hex digits each:
+  stamp, event and arg.  The header gives the count and cycles per us.
+
+  trace 3 700
+  0012A4F000010000 0012A61200020001 0012A7C000060016
+  trace end
+---------------------------------------------------------------------------*/
+void traceDump(void)
+   {
+   char line [80];
+   uint32_t first, last, pos, n;
+   TRACEREC *rec;
+
+   // Nothing is recorded while the records go out, including our own
+   // waits for the transmitter
+   traceOff = 1;
+   last  = __atomic_load_n(&traceHead, __ATOMIC_RELAXED);
+   first = (last > TRACE_SIZE) ? last - TRACE_SIZE : 0;
+
+   pos = 0;
+   line [pos++] = 't'; line [pos++] = 'r'; line [pos++] = 'a';
+   line [pos++] = 'c'; line [pos++] = 'e'; line [pos++] = ' ';
+   pos += fmtDec(last - first, &line [pos]);
+   line [pos++] = ' ';
+   pos += fmtDec(timer_cycles_per_us(), &line [pos]);
+   line [pos++] = '\n';
+   line [pos++] = '\r';
+   uartWrite(line, pos);
+
+   for (n = first, pos = 0; n != last; n++)
+      {
+      rec  = &traceBuf [n & (TRACE_SIZE-1)];
+      pos += fmtHex(rec->stamp, &line [pos]);
+      pos += fmtHex(((uint32_t)rec->event << 16) | rec->arg, &line [pos]);
+      line [pos++] = ' ';
+      if (((n - first) & 3) == 3 || n + 1 == last)
+         {
+         line [pos - 1] = '\n';
+         line [pos++]   = '\r';
+         uartWrite(line, pos);
+         pos = 0;
+         }
+      }
+   uartWrite("trace end\n\r", 11);
+
+   traceClear();
+   } // End traceDump()
+
+
+/*---------------------------------------------------------------------------
+  Empties the trace and starts recording again
+---------------------------------------------------------------------------*/
+void traceClear(void)
+   {
+   traceOff = 1;
+   __atomic_store_n(&traceHead, 0, __ATOMIC_RELAXED);
+   traceOff = 0;
+   } // End traceClear()
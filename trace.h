@@ -0,0 +1,49 @@
+//-------------------------------------------------------------------------
+// trace.h
+// Binary event trace.  A fixed ring of timestamped records written from
+// both the interrupt handler and the main loop, a slot is claimed with one
+// atomic add so neither side locks.  "trace dump" prints it as hex and
+// host/tracedec.c turns that into Chrome trace JSON.  Build with
+// -DTRACE_DISABLE to compile every TRACE() away.
+// 10/18/2026 - Initial version
+//-------------------------------------------------------------------------
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+
+#define TRACE_SIZE        1024            // records, power of 2
+
+// Events, arg in brackets
+#define TR_IRQ_ENTER      1
+#define TR_IRQ_EXIT       2               // bytes moved into rxRing
+#define TR_TX_DRAIN       3               // bytes moved from txRing
+#define TR_RX_DROP        4               // rxDropped so far
+#define TR_RX_THROTTLE    5
+#define TR_LINE           6               // line length, queued
+#define TR_QUEUE_FULL     7               // line queue depth
+#define TR_CMD_START      8               // line queue depth
+#define TR_CMD_ID         9               // parseData[] slot, 0xFFFF for none
+#define TR_CMD_END        10              // return code
+#define TR_TX_BLOCK       11
+#define TR_TX_UNBLOCK     12
+
+typedef struct
+   {
+   uint32_t stamp;                        // timer_cycles()
+   uint16_t event;
+   uint16_t arg;
+   } TRACEREC;
+
+#ifdef TRACE_DISABLE
+#define TRACE(event, arg)
+#else
+#define TRACE(event, arg) traceEvent((event), (arg))
+#endif
+
+void traceEvent(uint32_t event, uint32_t arg);
+void traceDump(void);
+void traceClear(void);
+
+#endif // TRACE_H
@@ -1,7 +1,7 @@
 //-------------------------------------------------------------------------
 // uart.c
 // This program implements an interrupt driven RPI serial receiver and
-// normal transmitter.
+// transmitter.
 // 07/07/2013 - Initial version
 // 10/10/2013 - updated comments, double echo the output
 // 11/07/2013 - update BAUD rate
@@ -11,23 +11,94 @@
 // 05/15/2014 - Removed mmio_write
 // 09/07/2014 - Add delay loop in putStr() to prevent Putty crashes
 // 12/15/2014 - Added a command line buffer and lab 13
+// 10/18/2026 - Interrupt driven transmitter using a circular buffer
+// 10/18/2026 - Register access through mmio.h, echoPoll() for host builds
+// 10/18/2026 - Optional RTS/CTS flow control, receive overflow counters
+// 10/18/2026 - Receive and transmit buffers on the lock free ring in ring.c
+// 10/18/2026 - Completed-line queue between line assembly and execution
+// 10/18/2026 - decStr() and the hex output on fmt.c, one write per number
+// 10/18/2026 - Measured GPIO pull-up/down waits from timer.c
+// 10/18/2026 - Transmit wait and CR to output latency for the stats command
+// 10/18/2026 - Event trace points, see trace.h
+// 10/18/2026 - Binary frame mode next to the command line, see frame.h
+// 10/18/2026 - Disk Error for return code 6
+// 10/18/2026 - uartWriteSome(), queue what fits without waiting
+// 10/18/2026 - A mode switch drops input sent before it was answered
 //-------------------------------------------------------------------------
 
 // #define LAB_13 1
 
+// RTS/CTS auto flow control on GPIO16/17.  When defined the interrupt
+// handler stops draining the receive FIFO once rxbuffer reaches
+// RX_HIGH_WATER, the FIFO fills and the mini UART drops RTS by itself.
+// #define UART_FLOW_CONTROL 1
+#define RX_HIGH_WATER   ((RXBUFMASK+1) - 256)
+#define RX_LOW_WATER    ((RXBUFMASK+1) / 2)
+#define RTS_AUTO_LEVEL  0                 // AUX_MU_CNTL_REG bits 5:4
+
 #include <stdint.h>
 #include "cmpe240.h"
-
-#define XMIT_SLOWDOWN   3000
+#include "mmio.h"
+#include "ring.h"
+#include "fmt.h"
+#include "timer.h"
+#include "trace.h"
+#include "frame.h"
 
 /*---------------------------------------------------------------------------
   Interrupt handler variables 
 ---------------------------------------------------------------------------*/
 #define  RXBUFMASK 0xFFF
-volatile uint32_t rxhead;
-volatile uint32_t rxtail;
-volatile unsigned char rxbuffer[RXBUFMASK+1];
-char cmdLine [100];
+static uint8_t rxbuffer[RXBUFMASK+1];
+RING rxRing = RING_INIT(rxbuffer);
+volatile uint32_t rxDropped;              // bytes lost, rxbuffer was full
+volatile uint32_t rxOverruns;             // receive FIFO overruns from LSR
+volatile uint32_t rxThrottled;            // receive interrupt held off
+void echoPoll(void);
+void uartWrite(const char *buf, uint32_t len);
+void statsLatency(uint32_t cycles);
+uint32_t parseFrame(uint32_t op, const uint8_t *data, uint32_t len, uint32_t *result);
+
+/*---------------------------------------------------------------------------
+  Transmit buffer variables, filled by uartPutC() and drained by the
+  interrupt handler on "transmit holding register empty"
+---------------------------------------------------------------------------*/
+#define  TXBUFMASK 0xFFF
+static uint8_t txbuffer[TXBUFMASK+1];
+RING txRing = RING_INIT(txbuffer);
+uint32_t txWaitCycles;                    // spent waiting for room in txRing
+
+// Mini UART Interrupt Enable bits, receive, transmit and the bit 2 that
+// uart_init() always sets
+#define  IER_RX         0x1
+#define  IER_TX         0x2
+#define  IER_ALWAYS     0x4
+
+/*---------------------------------------------------------------------------
+  Completed-line queue.  lineAssemble() echoes what was received and builds
+  the line in the slot at lineHead, a CR queues it.  lineExecute() runs the
+  slot at lineTail in place and frees it when the command is done.  Both
+  counters are free running, one slot is always the one being assembled.
+---------------------------------------------------------------------------*/
+#define  LINE_QUEUE_DEPTH 8               // power of 2
+typedef struct
+   {
+   char text [CMD_LINE_LEN+1];
+   uint32_t stamp;                        // timer_cycles() when the CR came
+   } CMDLINE;
+static CMDLINE  lineQueue [LINE_QUEUE_DEPTH];
+static uint32_t lineHead;                 // slot being assembled
+static uint32_t lineTail;                 // oldest queued line
+static uint32_t lineIndex;                // next character in lineHead's slot
+uint32_t lineDepthMax;                    // high-water mark of queued lines
+
+/*---------------------------------------------------------------------------
+  Binary frame mode, "mode bin".  frameAssemble() takes the place of
+  lineAssemble(), nothing is echoed and each frame is run as soon as it
+  is complete.
+---------------------------------------------------------------------------*/
+static uint32_t frameMode;
+static FRAMERX  frameIn;
 
 
 
@@ -38,15 +109,12 @@ char cmdLine [100];
 void uart_init(void)
    {
     uint32_t temp;
-    uint32_t *ptr;
 
     // Disable interrupts mmio_write(IRQ_DISABLE1,1<<29);
-    ptr = (uint32_t *)IRQ_DISABLE1;
-    *ptr = 1<<29;
+    REG_WRITE(IRQ_DISABLE1, 1<<29);
 
     // Enable the Auxiliary peripherals mio_write(AUX_ENABLES,1);
-    ptr = (uint32_t *)AUX_ENABLES;
-    *ptr = 1;
+    REG_WRITE(AUX_ENABLES, 1);
 
     // Mini UART Interrupt Enable
     // 31:8 Reserved, write zero, 
@@ -59,8 +127,7 @@ void uart_init(void)
     //      write: Writing with bit 1 set will clear the receive FIFO
     //             Writing with bit 2 set will clear the transmit FIFO
     // mmio_write(AUX_MU_IER_REG,0);
-    ptr = (uint32_t *)AUX_MU_IER_REG;
-    *ptr = 0;
+    REG_WRITE(AUX_MU_IER_REG, 0);
 
     // Mini UART Extra Control
     // 31:8 Reserved, write zero
@@ -75,8 +142,7 @@ void uart_init(void)
     // 1    Transmitter enable
     // 0    Receiver enable
     // mmio_write(AUX_MU_CNTL_REG,0);
-    ptr = (uint32_t *)AUX_MU_CNTL_REG;
-    *ptr = 0;
+    REG_WRITE(AUX_MU_CNTL_REG, 0);
 
     // Mini UART Line Control (start/stop bits)  
     // 31:8 Reserved, write zero, read as dont care
@@ -85,8 +151,7 @@ void uart_init(void)
     // 5:1  reserved     bit 1 must be 1  
     // 0    data size   0= 7-bit, 1= 8-bit mode
     // mmio_write(AUX_MU_LCR_REG,3);   // 8 bit mode
-    ptr = (uint32_t *)AUX_MU_LCR_REG;
-    *ptr = 3;
+    REG_WRITE(AUX_MU_LCR_REG, 3);
 
     // Mini UART Modem Control
     // 31:8 Reserved, write zero, read as dont care
@@ -97,8 +162,7 @@ void uart_init(void)
     //                Ignored if the RTS is used for auto-flow
     // 0    Reserved, write zero,  function in a 16550 UART but ignored
     // mmio_write(AUX_MU_MCR_REG,0);
-    ptr = (uint32_t *)AUX_MU_MCR_REG;
-    *ptr = 0;
+    REG_WRITE(AUX_MU_MCR_REG, 0);
 
     // Mini UART Interrupt Enable
     // 31:8 Reserved, write zero, r
@@ -113,8 +177,7 @@ void uart_init(void)
     // 0    Interrupt pending  - Cleared when pending
     // 5 = 0000 0000 0000 0000 0000 0000 0000 0101
     // mmio_write(AUX_MU_IER_REG,0x5);    //enable rx interrupts
-    ptr = (uint32_t *)AUX_MU_IER_REG;
-    *ptr = 0x5;
+    REG_WRITE(AUX_MU_IER_REG, 0x5);
 
     // Mini UART Interrupt Identify
     //31:8 Reserved, write zero, 
@@ -129,13 +192,11 @@ void uart_init(void)
     //   0xc6 = 0000 0000 0000 0000 0000 0000 0110 1100
     //  
     // mmio_write(AUX_MU_IIR_REG,0xC6);
-    ptr = (uint32_t *)AUX_MU_IIR_REG;
-    *ptr = 0xC6;
+    REG_WRITE(AUX_MU_IIR_REG, 0xC6);
 
     //Mini UART Baud rate   ((250,000,000/115200)/8)-1 = 270
     // mmio_write(AUX_MU_BAUD_REG,RPI_BAUD_57600);
-    ptr = (uint32_t *)AUX_MU_BAUD_REG;
-    *ptr = RPI_BAUD_57600;
+    REG_WRITE(AUX_MU_BAUD_REG, RPI_BAUD_57600);
 
     // GPIO Function Select 1
     // Each of the GPFSELn registers controls the functions of ten GPIO pins. 
@@ -147,16 +208,20 @@ void uart_init(void)
     // We only want to set our pin mode not affect other, so use and/or
     // to mask out the bits we want to change 
     // temp=mmio_read(GPFSEL1);
-    ptr = (uint32_t *)GPFSEL1;
-    temp = *ptr;
+    temp = REG_READ(GPFSEL1);
 
     temp &= ~(7<<12);    //gpio14
     temp |= 2<<12;    //alt5
     temp &= ~(7<<15);    //gpio15
     temp |= 2<<15;    //alt5
+#ifdef UART_FLOW_CONTROL
+    temp &= ~(7<<18);    //gpio16 CTS
+    temp |= 2<<18;    //alt5
+    temp &= ~(7<<21);    //gpio17 RTS
+    temp |= 2<<21;    //alt5
+#endif
     //mmio_write(GPFSEL1,temp);
-    ptr = (uint32_t *)GPFSEL1;
-    *ptr = temp;
+    REG_WRITE(GPFSEL1, temp);
 
 
     /*-----------------------------------------------------------------------
@@ -176,27 +241,27 @@ void uart_init(void)
     // 1 .Disable pull up/down for all GPIO pins & delay for 150 cycles.
 
     // mmio_write(GPPUD,0);
-    ptr = (uint32_t *)GPPUD;
-    *ptr = 0;
-        for(temp = 0; temp < DELAY_CYCLES; temp++) dummy();
+    REG_WRITE(GPPUD, 0);
+    delay_cycles(DELAY_CYCLES);
 
     // GPIO Pin Pull-up/down Enable Clock 0
     // 3. Disable pull up/down for pin 14,15 & delay for 150 cycles.
     // mmio_write(GPPUDCLK0,(1<<14)|(1<<15));
-    ptr = (uint32_t *)GPPUDCLK0;
-    *ptr = (1<<14)|(1<<15);
-        for(temp = 0; temp < DELAY_CYCLES; temp++) dummy();
+#ifdef UART_FLOW_CONTROL
+    REG_WRITE(GPPUDCLK0, (1<<14)|(1<<15)|(1<<16)|(1<<17));
+#else
+    REG_WRITE(GPPUDCLK0, (1<<14)|(1<<15));
+#endif
+    delay_cycles(DELAY_CYCLES);
 
     //  5. Write to GPPUD to remove the control signal
     // mmio_write(GPPUD,0);
-    ptr = (uint32_t *)GPPUD;
-    *ptr = 0;
+    REG_WRITE(GPPUD, 0);
 
     // GPIO Pin Pull-up/down Enable Clock 0
     // 6. Write 0 to GPPUDCLK0 to make it take effect.
     // mmio_write(GPPUDCLK0,0);
-    ptr = (uint32_t *)GPPUDCLK0;
-    *ptr = 0;
+    REG_WRITE(GPPUDCLK0, 0);
 
     // Mini UART Extra Control
     // 31:8 Reserved, write zero
@@ -212,56 +277,73 @@ void uart_init(void)
     // 0    Receiver enable
     // 3 = 0000 0000 0000 0000 0000 0000 0000 0011
     // mmio_write(AUX_MU_CNTL_REG,3);
-    ptr = (uint32_t *)AUX_MU_CNTL_REG;
-    *ptr = 3;
+#ifdef UART_FLOW_CONTROL
+    REG_WRITE(AUX_MU_CNTL_REG, (RTS_AUTO_LEVEL<<4) | 0xF);
+#else
+    REG_WRITE(AUX_MU_CNTL_REG, 3);
+#endif
 
     // Enable interrupts
     // mmio_write(IRQ_ENABLE1,1<<29);
-    ptr = (uint32_t *)IRQ_ENABLE1;
-    *ptr = 1<<29;
+    REG_WRITE(IRQ_ENABLE1, 1<<29);
 
     return;
    }  // End uart_init()
 
 
 /*---------------------------------------------------------------------------
-  Writes a byte to the serial port by waiting 
+  Mini UART Interrupt Enable, receive unless throttled and transmit if tx.
+  Both the main loop and the interrupt handler write it.  A write from the
+  main loop that an interrupt makes stale only causes one extra interrupt,
+  the handler works out the right value again.
+---------------------------------------------------------------------------*/
+static void uartSetIer(uint32_t tx)
+   {
+   REG_WRITE(AUX_MU_IER_REG, IER_ALWAYS | (rxThrottled ? 0 : IER_RX) | (tx ? IER_TX : 0));
+   } // End uartSetIer()
+
+
+/*---------------------------------------------------------------------------
+  Mini UART Line Status, counting receiver overruns since reading the
+  register clears the overrun bit
+  31:7 Reserved, write zero
+  6    Transmitter idle
+  5    Transmitter empty, the transmit FIFO can take a byte
+  4:2  Reserved, write zero
+  1    Receiver Overrun
+  0    Data ready
+---------------------------------------------------------------------------*/
+static uint32_t uartLineStatus(void)
+   {
+   uint32_t lsr = REG_READ(AUX_MU_LSR_REG);
+   if (lsr & 0x02) rxOverruns++;
+   return lsr;
+   } // End uartLineStatus()
+
+
+/*---------------------------------------------------------------------------
+  Writes a byte to the transmit circular buffer.  This only waits when the
+  buffer is full, the interrupt handler moves the bytes to the mini UART.
 ---------------------------------------------------------------------------*/
 void uartPutC(const char character)
    {
-   uint32_t *ptr;
-   // Wait for the port to be ready
-   while(1)
+   // Wait for room, the interrupt handler is draining the other end
+   if (!ring_put(&txRing, (uint8_t)character))
       {
-      // Mini UART Line Status
-      // 31:7 Reserved, write zero
-      // 6    Transmitter idle  
-      // 5    Transmitter empty
-      // 4:2  Reserved, write zero
-      // 1    Receiver Overrun
-      // 0    Data ready 
-      // 0x60 = 0000 0000 0000 0000 0000 0000 0110 0000
-      ptr = (uint32_t *)AUX_MU_LSR_REG;
-      if ((*ptr & 0x60) == 0x60) break;   // xmiterr idle & empty
-      }  // End while
-
-
-   // Some RPI's report idle AND empty when they are not 100% idle and empty
-   // Delay 150 cycles 
-   for(int temp = 0; temp < DELAY_CYCLES; temp++) dummy();
-
- 
-   //Mini UART I/O Data
-   // 31:8 Reserved, write zero
-   // 7:0 LS 8 bits Baud rate read/write, DLAB=1
-   //        Access to the LS 8 bits of the 16-bit baud rate register.
-   // 7:0 Transmit data, DLAB=0
-   //        Data written is put in the transmit FIFO 
-   // 7:0 Receive data read, DLAB=0
-   //        Data read is taken from the receive FIFO 
-   // mmio_write(AUX_MU_IO_REG, character);
-    ptr = (uint32_t *)AUX_MU_IO_REG;
-    *ptr = character;
+      uint32_t start = timer_cycles();
+
+      TRACE(TR_TX_BLOCK, 0);
+      while (!ring_put(&txRing, (uint8_t)character))
+         {
+         REG_IDLE();
+         }  // End while
+      txWaitCycles += timer_cycles() - start;
+      TRACE(TR_TX_UNBLOCK, 0);
+      }
+
+   // Arm the transmit holding register empty interrupt, the interrupt
+   // handler turns it back off once the circular buffer is empty
+   uartSetIer(1);
    return;
    }  // End uartPutC()
 
@@ -271,18 +353,58 @@ void uartPutC(const char character)
 ---------------------------------------------------------------------------*/
 void uartPutStr(const char *str)
    {
-   while (*str != 0x00)
-      {
-      uartPutC(*str);
-      str++;
-      
-      // Slow uartPutStr() to prevent PuTTy crashes on the PC
-      for (int temp = 0; temp < XMIT_SLOWDOWN; temp++) dummy();
+   uint32_t len = 0;
 
-      }
+   while (str[len] != 0x00) len++;
+   uartWrite(str, len);
    } // end uartPutStr()
 
 
+/*---------------------------------------------------------------------------
+  Writes len bytes to the transmit circular buffer in as few copies as the
+  free space allows, waiting only while the buffer is full.
+---------------------------------------------------------------------------*/
+void uartWrite(const char *buf, uint32_t len)
+   {
+   uint32_t done, start;
+
+   while (len != 0)
+      {
+      done = ring_write(&txRing, (const uint8_t *)buf, len);
+      if (done != 0)
+         {
+         uartSetIer(1);
+         buf += done;
+         len -= done;
+         }
+      else
+         {
+         start = timer_cycles();
+         TRACE(TR_TX_BLOCK, 0);
+         while (ring_space(&txRing) == 0)
+            {
+            REG_IDLE();
+            }
+         txWaitCycles += timer_cycles() - start;
+         TRACE(TR_TX_UNBLOCK, 0);
+         }
+      } // End while
+   } // end uartWrite()
+
+
+/*---------------------------------------------------------------------------
+  Queues as much of the len bytes as the transmit buffer has room for right
+  now and returns how many that was, it never waits.
+---------------------------------------------------------------------------*/
+uint32_t uartWriteSome(const char *buf, uint32_t len)
+   {
+   uint32_t done = ring_write(&txRing, (const uint8_t *)buf, len);
+
+   if (done != 0) uartSetIer(1);
+   return done;
+   } // end uartWriteSome()
+
+
 /*---------------------------------------------------------------------------
   The routine converts an unsigned number to character decimal.  The buffer
   must be a minimum of 11 bytes long.
@@ -290,65 +412,28 @@ void uartPutStr(const char *str)
   Where: 
    uint32_t num   - number to be converted to character
    uint8_t  buff   - pointer to a buffer to hold the answer, must be 11 bytes
-                 leading zeros will be stripped.
+                 leading zeros will be stripped, zero prints as 0.
 ---------------------------------------------------------------------------*/
 void decStr(uint32_t num, uint8_t *buff)
-{
-   // An 32 bit in can only be 2**32-1 or 4,294,967,295
-   uint32_t nums [9] = {100000000, 10000000, 1000000, 100000, 10000, 1000, 100, 10, 1};
-   uint32_t i, digit;
-   uint32_t first = 0;                  // The first non-zero value
-   uint32_t indx = 0;                  // Output buffer index
-
-   for(i =0; i < 9; i++)
    {
-      digit = 0;
-      // Needs conversion
-      while (num >= nums [i])
-      {
-         digit++;
-         num -= nums[i];
-      }
-      if (digit) { first = 1;}         // skip all leading zeroes
-      if (first) 
-      {
-         buff [indx] = digit + 0x30;      // Convert to character
-         indx++;
-      }
-   }
-   // always null terminate
-   buff [indx] = 0x00;
-}
+   // An 32 bit in can only be 2**32-1 or 4,294,967,295
+   fmtDec(num, (char *)buff);
+   } // End decStr()
 
 
 
 /*---------------------------------------------------------------------------
-  This converts an integer binary string to printable hex using a masking
-  technique and then write a space character
+  This converts an integer binary string to printable hex and then writes
+  a space character
 ---------------------------------------------------------------------------*/
 void uartHexStrings(uint32_t data)
    {
-    //uint32_t ra;
-    uint32_t readBits;
-    uint32_t rdChar;
+   char buff [FMT_HEX_LEN];
 
-    readBits=32;
-    while(1)
-       {
-       // Mask out a nibble
-       readBits -= 4;
-       rdChar = (data >> readBits) &0xF;
-
-       //Convert the nibble to character hex
-       if (rdChar > 9) rdChar += 0x37; else rdChar += 0x30;
- 
-       // Send the byte out
-       uartPutC(rdChar);
-       if (readBits ==0) break;
-       }
-
-   // display a space character
-   uartPutC(0x20);
+   // The NUL is overwritten with the space
+   fmtHex(data, buff);
+   buff [8] = 0x20;
+   uartWrite(buff, 9);
    } // end uartHexStrings()
 
 
@@ -359,9 +444,13 @@ void uartHexStrings(uint32_t data)
 ---------------------------------------------------------------------------*/
 void uartHexString ( uint32_t d )
    {
-    uartHexStrings(d);
-    uartPutC(0x0D);
-    uartPutC(0x0A);
+   char buff [FMT_HEX_LEN + 2];
+
+   fmtHex(d, buff);
+   buff [8]  = 0x20;
+   buff [9]  = 0x0D;
+   buff [10] = 0x0A;
+   uartWrite(buff, 11);
    } // end uartHexString()
 
 
@@ -370,76 +459,229 @@ void uartHexString ( uint32_t d )
 ---------------------------------------------------------------------------*/
 void echoBuffer(void)
    {
-	uint32_t cmdIndex = 0;
    // Process forever, looking for data to change due to interrupt activity
     while(1)
        {
-       // The only way for data to get into here is via the interrupt handler
-        while(rxtail!=rxhead)
-           {
-           // Echo the character back  
-           uartPutC(rxbuffer[rxtail]);
-             
-           // Add a LF if necessary and execut the command
-           if (rxbuffer[rxtail] == '\r') 
-           { 
-              uartPutC('\n');
-              cmdLine [cmdIndex] = '\0';
- //             uartPutStr("command line ");
-             // uartPutStr(cmdLine);
- //             uartPutStr("\r\n");
-			  int resp;
-              resp = parseCmdLine(cmdLine);
-			  switch(resp) { 
-				default: uartPutStr("Unexpected behavior!\n\r\0");
-				case 0: break;
-				case 1: uartPutStr("Too Few Arguments.\n\r\0"); break;
-				case 2: uartPutStr("Invalid Argument Size.\n\r\0"); break;
-				case 3: uartPutStr("Invalid Hex Argument\n\r\0"); break;
-				case 5: uartPutStr("File not found\n\r\0"); break;
-				case 10: uartPutStr("Syntax Error\n\r\0"); break;
-			  }
-              cmdIndex = 0;
-			  
-           } // End if \r
-           else
-           {           
-              // Copy the character 
-              cmdLine [cmdIndex] = rxbuffer [rxtail];
- 
-              // Handle the back spaces
-              if ((rxbuffer [rxtail] == ASCII_DELETE) || (rxbuffer [rxtail] == ASCII_BSPACE))
-                {
-                    // Don't back up too far
-                    if (cmdIndex == 1)  { cmdIndex = 0; }
-                    else {cmdIndex--;}
-                }
-                else
-                {
-                    cmdIndex++;
-                    //  Don't over index
-                    if (cmdIndex > CMD_LINE_LEN) { cmdIndex = CMD_LINE_LEN; }
-                } // End if
-                    
-           } // End else \r
-           
-           // Increment our circular pointer
-           rxtail = (rxtail+1) & RXBUFMASK;
-         
-           }  // End if data in the circular buffer
+       echoPoll();
        }  // End while
    } // End echoBuffer()
 
 
+/*---------------------------------------------------------------------------
+  Number of completed lines waiting to be executed
+---------------------------------------------------------------------------*/
+uint32_t lineQueueDepth(void)
+   {
+   return lineHead - lineTail;
+   } // End lineQueueDepth()
+
+
+/*---------------------------------------------------------------------------
+  Echoes everything in the receive buffer and assembles it into lines,
+  handling back spaces.  Each CR queues the line, unless the queue is full,
+  in which case the CR stays in the receive buffer until a slot frees up.
+---------------------------------------------------------------------------*/
+static void lineAssemble(void)
+   {
+   const uint8_t *data;
+   uint32_t len, n;
+   char *line;
+
+   // The only way for data to get into here is via the interrupt handler.
+   // Take whatever is contiguous in the ring and cut it at the first CR.
+   while ((len = ring_read_span(&rxRing, &data)) != 0)
+      {
+      line = lineQueue [lineHead & (LINE_QUEUE_DEPTH-1)].text;
+      for (n = 0; n < len && data[n] != '\r'; n++)
+         {
+         // Handle the back spaces, don't back up past the start
+         if ((data[n] == ASCII_DELETE) || (data[n] == ASCII_BSPACE))
+            {
+            if (lineIndex != 0) lineIndex--;
+            }
+         //  Copy the character, don't over index
+         else if (lineIndex < CMD_LINE_LEN)
+            {
+            line [lineIndex++] = data[n];
+            }
+         } // End for
+
+      // Echo the piece back in one go
+      uartWrite((const char *)data, n);
+      ring_consume(&rxRing, n);
+      if (n == len) continue;
+
+      // A CR, leave it for later if there is no slot for the next line
+      if (lineHead - lineTail >= LINE_QUEUE_DEPTH-1)
+         {
+         TRACE(TR_QUEUE_FULL, lineHead - lineTail);
+         break;
+         }
+
+      line [lineIndex] = '\0';
+      lineQueue [lineHead & (LINE_QUEUE_DEPTH-1)].stamp = timer_cycles();
+      TRACE(TR_LINE, lineIndex);
+      lineIndex = 0;
+      lineHead++;
+      if (lineHead - lineTail > lineDepthMax) lineDepthMax = lineHead - lineTail;
+
+      // Echo the CR and add a LF
+      uartWrite("\r\n", 2);
+      ring_consume(&rxRing, 1);
+      }  // End while data in the circular buffer
+   } // End lineAssemble()
+
+
+/*---------------------------------------------------------------------------
+  Runs the oldest queued line and reports any error
+---------------------------------------------------------------------------*/
+static void lineExecute(void)
+   {
+   CMDLINE *line = &lineQueue [lineTail & (LINE_QUEUE_DEPTH-1)];
+   int resp;
+
+   TRACE(TR_CMD_START, lineHead - lineTail);
+   resp = parseCmdLine(line->text);
+   switch(resp) {
+      default: uartPutStr("Unexpected behavior!\n\r\0");
+      case 0: break;
+      case 1: uartPutStr("Too Few Arguments.\n\r\0"); break;
+      case 2: uartPutStr("Invalid Argument Size.\n\r\0"); break;
+      case 3: uartPutStr("Invalid Hex Argument\n\r\0"); break;
+      case 5: uartPutStr("File not found\n\r\0"); break;
+      case 6: uartPutStr("Disk Error\n\r\0"); break;
+      case 10: uartPutStr("Syntax Error\n\r\0"); break;
+   }
+   statsLatency(timer_cycles() - line->stamp);
+   TRACE(TR_CMD_END, resp);
+   lineTail++;
+   } // End lineExecute()
+
+
+/*---------------------------------------------------------------------------
+  Queues one frame of n result words
+---------------------------------------------------------------------------*/
+static void frameReply(uint32_t op, uint32_t status, const uint32_t *word, uint32_t n)
+   {
+   uint8_t buf [FRAME_MAX];
+
+   uartWrite((const char *)buf, frameEncode(op, status, word, n, buf));
+   } // End frameReply()
+
+
+/*---------------------------------------------------------------------------
+  Switches between the command line and binary frames, on is 1 for frames.
+  Either way the switch is answered with an empty FRAME_OP_MODE frame, the
+  host waits for it before sending in the new mode.  Anything that came in
+  ahead of that answer is dropped without being run: lines queued behind
+  "mode bin", a partial line or frame, and bytes not yet assembled.  Run
+  as text they would put text replies into the frame stream, and read as
+  frames they would only fail their CRC.  "mode bin" is itself the line at
+  lineTail, lineExecute() frees it when this returns.
+---------------------------------------------------------------------------*/
+void uartFrameMode(uint32_t on)
+   {
+   if (lineHead != lineTail) lineHead = lineTail + 1;
+   ring_consume(&rxRing, ring_count(&rxRing));
+   frameMode   = on;
+   frameIn.pos = 0;
+   lineIndex   = 0;
+   frameReply(FRAME_OP_MODE, FRAME_ST_OK, 0, 0);
+   } // End uartFrameMode()
+
+
+/*---------------------------------------------------------------------------
+  Runs the frame in frameIn, got is what frameRx() said about it, and
+  answers with one frame.  A frame that failed its CRC is not run.
+---------------------------------------------------------------------------*/
+static void frameExecute(uint32_t got)
+   {
+   uint32_t stamp = timer_cycles();
+   uint32_t result;
+   uint32_t rc;
+
+   TRACE(TR_CMD_START, 0);
+   if (got == FRAME_BAD)
+      {
+      frameReply(frameIn.op, FRAME_ST_BAD_CRC, 0, 0);
+      rc = FRAME_ST_BAD_CRC;
+      }
+   else if (frameIn.op == FRAME_OP_MODE && frameIn.len == 0)
+      {
+      uartFrameMode(0);
+      rc = FRAME_ST_OK;
+      }
+   else
+      {
+      rc = parseFrame(frameIn.op, frameIn.data, frameIn.len, &result);
+      frameReply(frameIn.op, rc, &result, rc == 0);
+      statsLatency(timer_cycles() - stamp);
+      }
+   TRACE(TR_CMD_END, rc);
+   } // End frameExecute()
+
+
+/*---------------------------------------------------------------------------
+  Feeds the receive buffer to frameIn up to the end of the next complete
+  frame, if there is one, and runs it.
+---------------------------------------------------------------------------*/
+static void frameAssemble(void)
+   {
+   const uint8_t *data;
+   uint32_t len, n;
+   uint32_t got = FRAME_MORE;
+
+   while (got == FRAME_MORE && (len = ring_read_span(&rxRing, &data)) != 0)
+      {
+      for (n = 0; n < len && got == FRAME_MORE; n++)
+         {
+         got = frameRx(&frameIn, data[n]);
+         }
+      ring_consume(&rxRing, n);
+      }
+   if (got != FRAME_MORE) frameExecute(got);
+   } // End frameAssemble()
+
+
+/*---------------------------------------------------------------------------
+  This subroutine echoes and queues whatever is in the circular buffer right
+  now, runs at most one queued line and then returns.  In frame mode it
+  runs at most one frame instead.  Host builds call it in their own loop.
+---------------------------------------------------------------------------*/
+void echoPoll(void)
+   {
+   if (frameMode)
+      frameAssemble();
+   else
+      lineAssemble();
+   if (lineTail != lineHead)
+      {
+      lineExecute();
+      }
+
+#ifdef UART_FLOW_CONTROL
+   // Let the receive interrupt back in once there is room again
+   if (rxThrottled && ring_count(&rxRing) < RX_LOW_WATER)
+      {
+      rxThrottled = 0;
+      uartSetIer(ring_count(&txRing) != 0);
+      }
+#endif
+   } // End echoPoll()
+
+
 
 /*---------------------------------------------------------------------------
   Called from an assembly language routine that saves the stack
 ---------------------------------------------------------------------------*/
-void __attribute__((interrupt)) c_irq_handler( void )
+void IRQ_HANDLER c_irq_handler( void )
    {
    uint32_t status, readChar;
-   uint32_t *ptr;
+   uint32_t rxCount = 0;
+   uint32_t txCount;
+   uint8_t txChar;
 
+   TRACE(TR_IRQ_ENTER, 0);
    //an interrupt has occurred, find out why
    while(1) //resolve all interrupts to uart
         {
@@ -456,8 +698,7 @@ void __attribute__((interrupt)) c_irq_handler( void )
         //                bit 2 set will clear the transmit FIFO
         //   0 - Interrupt pending - This bit is 0 whenever an interrupt is pending
         // eg:
-        ptr = (uint32_t *)AUX_MU_IIR_REG;
-        status = *ptr;
+        status = REG_READ(AUX_MU_IIR_REG);
 
          // If bit 0 is 1, then no more interrupts pending
         if ((status & 0x01) == 1) break; //no more interrupts
@@ -465,6 +706,17 @@ void __attribute__((interrupt)) c_irq_handler( void )
          // If bit 2:1 is 10 then the receiver holds a byte
         if ((status & 0x06) == 4)
            {
+#ifdef UART_FLOW_CONTROL
+           // Nearly full, leave the bytes in the receive FIFO so the mini
+           // UART drops RTS, echoPoll() re-enables us below RX_LOW_WATER
+           if (ring_count(&rxRing) >= RX_HIGH_WATER)
+              {
+              rxThrottled = 1;
+              uartSetIer(ring_count(&txRing) != 0);
+              TRACE(TR_RX_THROTTLE, 0);
+              continue;
+              }
+#endif
            //receiver holds a valid byte
            // Mini UART I/O Data
            // 31:8 Reserved, write zero
@@ -474,14 +726,40 @@ void __attribute__((interrupt)) c_irq_handler( void )
            //        Data written is put in the transmit FIFO 
            // 7:0 Receive data read, DLAB=0
            //        Data read is taken from the receive FIFO 
-           ptr = (uint32_t *)AUX_MU_IO_REG; //read byte from rx FIFO
-           readChar = *ptr;
+           uartLineStatus();
+           readChar = REG_READ(AUX_MU_IO_REG); //read byte from rx FIFO
+
+           // Put the data int our circular buffer, unless it is full
+           if (!ring_put(&rxRing, readChar & 0xFF))
+              {
+              rxDropped++;
+              TRACE(TR_RX_DROP, rxDropped);
+              continue;
+              }
+           rxCount++;
+           } // End if
 
-           // Put the data int our circular buffer
-           rxbuffer[rxhead] = readChar & 0xFF;
-           rxhead           = (rxhead+1) & RXBUFMASK;
+         // If bit 2:1 is 01 then the transmit holding register is empty
+        if ((status & 0x06) == 2)
+           {
+           // Line status bit 5 is set while the transmit FIFO can take a byte
+           txCount = 0;
+           while ((uartLineStatus() & 0x20) && ring_get(&txRing, &txChar))
+              {
+              REG_WRITE(AUX_MU_IO_REG, txChar);
+              txCount++;
+              } // End while
+           TRACE(TR_TX_DRAIN, txCount);
+
+           // Nothing left to send, turn off the transmit interrupt
+           if (ring_count(&txRing) == 0)
+              {
+              uartSetIer(0);
+              } // End if
            } // End if
-         } // End while 
+         } // End while
+
+   TRACE(TR_IRQ_EXIT, rxCount);
 } // End c_irq_handler()
 
 